@@ -0,0 +1,205 @@
+#include "BenchHarness.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+
+using namespace std;
+
+/**
+ * @brief Reads `--data`, `--work-dir`, `--scales=1,10`, `--min-time` and `--filter` from the command line.
+ *
+ * @param argc Argument count from main.
+ * @param argv Arguments from main.
+ * @param options Receives the options; unspecified ones keep their defaults.
+ * @return True if every argument was understood, false otherwise.
+ */
+bool parseBenchOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        size_t equals = argument.find('=');
+        string name = argument.substr(0, equals);
+        string value = equals == string::npos ? "" : argument.substr(equals + 1);
+        if (name == "--data") {
+            options.dataFile = value;
+        } else if (name == "--work-dir") {
+            options.workDir = value;
+        } else if (name == "--min-time") {
+            options.minSeconds = atof(value.c_str());
+        } else if (name == "--filter") {
+            options.filter = value;
+        } else if (name == "--scales") {
+            options.scales.clear();
+            stringstream list(value);
+            string scale;
+            while (getline(list, scale, ',')) {
+                if (atoi(scale.c_str()) > 0) {
+                    options.scales.push_back(atoi(scale.c_str()));
+                }
+            }
+        } else {
+            cerr << "Unknown option " << argument << "\n"
+                 << "Usage: " << argv[0] << " [--data=us_postal_codes.csv] [--work-dir=bench_data]"
+                 << " [--scales=1,10,100] [--min-time=0.5] [--filter=name]" << endl;
+            return false;
+        }
+    }
+    mkdir(options.workDir.c_str(), 0755);
+    return !options.scales.empty();
+}
+
+/**
+ * @brief Gets the size of a file.
+ *
+ * @param path Path of the file.
+ * @return Size in bytes, or 0 if the file is missing.
+ */
+size_t fileBytes(const string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+/**
+ * @brief Writes a copy of a zip code CSV holding `scale` times its records.
+ *
+ * @param source Bundled CSV file.
+ * @param target Scaled CSV file to write.
+ * @param scale Number of copies of the source records.
+ * @param records Receives the number of records in the target.
+ * @return True if successful, false otherwise.
+ */
+bool makeScaledCsv(const string& source, const string& target, int scale, size_t& records) {
+    ifstream in(source);
+    if (!in.is_open()) {
+        cerr << "Error: Could not open " << source << endl;
+        return false;
+    }
+    string header;
+    getline(in, header);
+    vector<string> rows;
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty()) rows.push_back(line);
+    }
+    records = rows.size() * scale;
+
+    // Reuse a dataset left by an earlier run
+    size_t expected = header.size() + 1;
+    for (int copy = 0; copy < scale; copy++) {
+        for (const string& row : rows) {
+            size_t comma = row.find(',');
+            long zip = atol(row.c_str()) + copy * 100000L;
+            expected += to_string(zip).size() + (row.size() - comma) + 1;
+        }
+    }
+    if (fileBytes(target) == expected) {
+        return true;
+    }
+
+    ofstream out(target, ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open " << target << endl;
+        return false;
+    }
+    out << header << "\n";
+    for (int copy = 0; copy < scale; copy++) {
+        for (const string& row : rows) {
+            size_t comma = row.find(',');
+            out << atol(row.c_str()) + copy * 100000L << row.substr(comma) << "\n";
+        }
+    }
+    return out.good();
+}
+
+/**
+ * @brief Creates a runner printing to cout.
+ *
+ * @param options Options of the benchmark program.
+ */
+BenchRunner::BenchRunner(const BenchOptions& options) : options(options), headerPrinted(false) {}
+
+/**
+ * @brief Formats a rate with a k/M/G suffix.
+ *
+ * @param value Rate per second.
+ * @return Text such as "12.3M/s".
+ */
+static string formatRate(double value) {
+    const char* suffixes[] = {"", "k", "M", "G"};
+    int suffix = 0;
+    while (value >= 1000.0 && suffix < 3) {
+        value /= 1000.0;
+        suffix++;
+    }
+    ostringstream text;
+    text << fixed << setprecision(value < 10 ? 2 : 1) << value << suffixes[suffix] << "/s";
+    return text.str();
+}
+
+/**
+ * @brief Runs one case until the minimum time is reached.
+ *
+ * @param name Case name, e.g. "createBlockFile/10x".
+ * @param records Records processed by one iteration.
+ * @param bytes Bytes read by one iteration.
+ * @param body One iteration of the case.
+ * @param setup Work done before every iteration and not timed; may be empty.
+ */
+void BenchRunner::run(const string& name, size_t records, size_t bytes,
+                      const function<void()>& body, const function<void()>& setup) {
+    if (!options.filter.empty() && name.find(options.filter) == string::npos) {
+        return;
+    }
+    if (!headerPrinted) {
+        cout << left << setw(40) << "Benchmark" << right << setw(14) << "Time" << setw(12) << "Iterations"
+             << setw(14) << "Records" << setw(12) << "MB/s" << "\n" << string(92, '-') << endl;
+        headerPrinted = true;
+    }
+
+    // Output of the code under test would dominate the timing
+    ofstream discard("/dev/null");
+    streambuf* savedOut = cout.rdbuf(discard.rdbuf());
+    streambuf* savedErr = cerr.rdbuf(discard.rdbuf());
+
+    size_t iterations = 0;
+    double seconds = 0;
+    while (iterations == 0 || seconds < options.minSeconds) {
+        if (setup) setup();
+        auto start = chrono::steady_clock::now();
+        body();
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        iterations++;
+    }
+
+    cout.rdbuf(savedOut);
+    cerr.rdbuf(savedErr);
+
+    double perIteration = seconds / iterations;
+    ostringstream time;
+    time << fixed << setprecision(perIteration < 0.01 ? 3 : 1);
+    if (perIteration < 1.0) {
+        time << perIteration * 1e3 << " ms";
+    } else {
+        time << perIteration << " s";
+    }
+    cout << left << setw(40) << name << right << setw(14) << time.str() << setw(12) << iterations
+         << setw(14) << formatRate(records / perIteration)
+         << setw(12) << fixed << setprecision(1) << bytes / perIteration / 1e6 << endl;
+}
+
+/**
+ * @brief Runs untimed work that later cases depend on, such as writing their input file.
+ *
+ * @param body Work to run once.
+ */
+void BenchRunner::prepare(const function<void()>& body) {
+    ofstream discard("/dev/null");
+    streambuf* savedOut = cout.rdbuf(discard.rdbuf());
+    streambuf* savedErr = cerr.rdbuf(discard.rdbuf());
+    body();
+    cout.rdbuf(savedOut);
+    cerr.rdbuf(savedErr);
+}
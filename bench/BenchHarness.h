@@ -0,0 +1,101 @@
+/**
+ * @file BenchHarness.h
+ * @brief Small benchmark runner shared by the p2 and p3 I/O benchmarks.
+ *
+ * Follows the shape of Google Benchmark without depending on it: each case
+ * runs until it has taken a minimum time, then one line reports the time per
+ * iteration, the iteration count, and the throughput in records/s and MB/s.
+ * Datasets are the bundled CSV or copies of it scaled up with `makeScaledCsv`.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Options shared by every benchmark program.
+ */
+struct BenchOptions {
+    std::string dataFile = "us_postal_codes.csv";  ///< Bundled CSV the datasets are made from
+    std::string workDir = "bench_data";            ///< Directory receiving scaled datasets and outputs
+    std::vector<int> scales{1, 10, 100};           ///< Dataset sizes, as multiples of the bundled CSV
+    double minSeconds = 0.5;                       ///< Least time spent running each case
+    std::string filter;                            ///< Only cases whose name contains this run
+};
+
+/**
+ * @brief Reads `--data`, `--work-dir`, `--scales=1,10`, `--min-time` and `--filter` from the command line.
+ *
+ * @param argc Argument count from main.
+ * @param argv Arguments from main.
+ * @param options Receives the options; unspecified ones keep their defaults.
+ * @return True if every argument was understood, false otherwise.
+ */
+bool parseBenchOptions(int argc, char* argv[], BenchOptions& options);
+
+/**
+ * @brief Writes a copy of a zip code CSV holding `scale` times its records.
+ *
+ * Copy k adds k * 100000 to every zip code, so the zip codes stay unique and
+ * the file stays sorted by zip code when the source is. An existing target
+ * of the right size is reused.
+ *
+ * @param source Bundled CSV file.
+ * @param target Scaled CSV file to write.
+ * @param scale Number of copies of the source records.
+ * @param records Receives the number of records in the target.
+ * @return True if successful, false otherwise.
+ */
+bool makeScaledCsv(const std::string& source, const std::string& target, int scale, size_t& records);
+
+/**
+ * @brief Gets the size of a file.
+ *
+ * @param path Path of the file.
+ * @return Size in bytes, or 0 if the file is missing.
+ */
+size_t fileBytes(const std::string& path);
+
+/**
+ * @class BenchRunner
+ * @brief Times benchmark cases and prints one line per case.
+ */
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options);
+
+    /**
+     * @brief Runs one case until the minimum time is reached.
+     *
+     * Output written to cout or cerr by the case is discarded while it runs.
+     *
+     * @param name Case name, e.g. "createBlockFile/10x".
+     * @param records Records processed by one iteration.
+     * @param bytes Bytes read by one iteration.
+     * @param body One iteration of the case.
+     * @param setup Work done before every iteration and not timed; may be empty.
+     */
+    void run(const std::string& name, size_t records, size_t bytes,
+             const std::function<void()>& body, const std::function<void()>& setup = nullptr);
+
+    /**
+     * @brief Runs untimed work that later cases depend on, such as writing their input file.
+     *
+     * Output written to cout or cerr is discarded, and the filter does not apply.
+     *
+     * @param body Work to run once.
+     */
+    void prepare(const std::function<void()>& body);
+
+private:
+    BenchOptions options;
+    bool headerPrinted;
+};
+
+#endif // BENCH_HARNESS_H
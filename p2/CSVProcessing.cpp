@@ -1,5 +1,6 @@
 #include "buffer.h"
 #include "CSVProcessing.h"
+#include "ResultCache.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -14,11 +15,33 @@
 //         << ", Latitude: " << record.latitude
 //         << ", Longitude: " << record.longitude << std::endl;
 // }
+/**
+ * @brief Creates a processor reading us_postal_codes.csv.
+ */
+CSVProcessing::CSVProcessing() : input_file( "us_postal_codes.csv" ) {}
+
+/**
+ * @brief Creates a processor reading the given CSV file.
+ *
+ * @param input_file The path to the CSV file to process.
+ */
+CSVProcessing::CSVProcessing( const std::string& input_file ) : input_file( input_file ) {}
+
+/**
+ * @brief Creates a processor over an already loaded Buffer.
+ *
+ * @param buffer A Buffer filled by read_csv.
+ */
+CSVProcessing::CSVProcessing( std::shared_ptr<const Buffer> buffer )
+    : input_file( buffer ? buffer->get_file_name() : std::string() ), buffer( std::move( buffer ) ) {}
+
 /**
  * @brief Sorts the CSV buffer and finds the zip codes (eastmost, westmost, northmost, southmost) for each state.
  *
  * This method reads the CSV data, processes it to identify the easternmost, westernmost, northernmost,
  * and southernmost zip codes for each state, and then stores these in a map (automatically sorts alphebetically).
+ * Results are cached by ResultCache, so an unchanged input file is not parsed again, and the
+ * parsed Buffer is kept so later reports of this processor do not parse it again either.
  *
  * @return A map where the key is the state ID and the value is a vector containing the four ZipCodeRecord. The output looks as follows:
  * [stateID] : {
@@ -30,35 +53,67 @@
  * 
  */
 std::map<string, std::vector<ZipCodeRecord>> CSVProcessing::sortBuffer() {
-    float eastMost, westMost, northMost, southMost;
-    Buffer CSVBuffer;
-    CSVBuffer.read_csv( );
-    std::map<string, std::vector<ZipCodeRecord>> state_zip_map = CSVBuffer.get_state_zip_codes();
     std::map<string, std::vector<ZipCodeRecord>> sorted_directions;
-    for ( auto& state : state_zip_map ) {
+    if ( buffer ) {
+        return findDirections( *buffer );
+    }
+
+    // Reuse the results of an earlier run when the input has not changed since
+    CacheKey key;
+    bool keyed = ResultCache::fingerprint( input_file, key );
+    if ( keyed && ResultCache::lookup( key, sorted_directions ) ) {
+        std::cout << "Using cached results for " << input_file << std::endl;
+        return sorted_directions;
+    }
+
+    auto CSVBuffer = std::make_shared<Buffer>();
+    if ( !CSVBuffer->read_csv( input_file ) ) {
+        return sorted_directions;
+    }
+    buffer = CSVBuffer;
+    sorted_directions = findDirections( *buffer );
+    if ( keyed ) {
+        ResultCache::store( key, sorted_directions );
+    }
+    return sorted_directions;
+}
+
+/**
+ * @brief Finds the zip codes (eastmost, westmost, northmost, southmost) for each state of a loaded Buffer.
+ *
+ * @param CSVBuffer A Buffer filled by read_csv.
+ * @return A map of state ID to its { east, west, north, south } records, as returned by sortBuffer.
+ */
+std::map<string, std::vector<ZipCodeRecord>> CSVProcessing::findDirections( const Buffer& CSVBuffer ) {
+    // Walk each state's records through the buffer's state index instead of copying them
+    const std::vector<ZipCodeRecordView>& records = CSVBuffer.get_records();
+    std::map<string, std::vector<ZipCodeRecord>> sorted_directions;
+    for ( const auto& state : CSVBuffer.get_state_index() ) {
         const std::string& stateID = state.first;
-        const std::vector<ZipCodeRecord>& stateInfo = state.second;
-        // intial loading of directions
-        ZipCodeRecord easternmost = stateInfo[ 0 ];
-        ZipCodeRecord westernmost = stateInfo[ 0 ];
-        ZipCodeRecord northernmost = stateInfo[ 0 ];
-        ZipCodeRecord southernmost = stateInfo[ 0 ];
+        const std::vector<size_t>& statePositions = state.second;
+        // intial loading of directions; only the four winners are copied out of the buffer
+        const ZipCodeRecordView* easternmost = &records[ statePositions[ 0 ] ];
+        const ZipCodeRecordView* westernmost = easternmost;
+        const ZipCodeRecordView* northernmost = easternmost;
+        const ZipCodeRecordView* southernmost = easternmost;
         // checks if the current records zip is one of the maxed directions
-        for ( const auto& record : stateInfo ) {
-            if ( record.longitude < easternmost.longitude ) {
-                easternmost = record;
+        for ( size_t position : statePositions ) {
+            const ZipCodeRecordView& record = records[ position ];
+            if ( record.longitude < easternmost->longitude ) {
+                easternmost = &record;
             }
-            if ( record.longitude > westernmost.longitude ) {
-                westernmost = record;
+            if ( record.longitude > westernmost->longitude ) {
+                westernmost = &record;
             }
-            if ( record.latitude > northernmost.latitude ) {
-                northernmost = record;
+            if ( record.latitude > northernmost->latitude ) {
+                northernmost = &record;
             }
-            if ( record.latitude < southernmost.latitude ) {
-                southernmost = record;
+            if ( record.latitude < southernmost->latitude ) {
+                southernmost = &record;
             }
         }
-        sorted_directions[ stateID ] = { easternmost, westernmost, northernmost, southernmost };
+        sorted_directions[ stateID ] = { CSVBuffer.to_record( *easternmost ), CSVBuffer.to_record( *westernmost ),
+                                         CSVBuffer.to_record( *northernmost ), CSVBuffer.to_record( *southernmost ) };
         // std::cout << "State: " << stateID << std::endl;
         // std::cout << "  Easternmost: ";
         // printZipCodeRecord( easternmost );
@@ -77,9 +132,8 @@ std::map<string, std::vector<ZipCodeRecord>> CSVProcessing::sortBuffer() {
     //     { northern most zip, stateID, directions },
     //     { southern most zip, stateID, directions }
     // }
-    
     return sorted_directions;
-}   
+}
 
 /**
  * @brief Creates and adds a header to the CSV file.
@@ -111,6 +165,10 @@ void CSVProcessing::addHeader(std::string& file_name) {
  */
 bool CSVProcessing::csvOutput(std::string& file_name) {
     std::map<std::string, std::vector<ZipCodeRecord>> sorted_data = sortBuffer();
+    if ( sorted_data.empty() ) {
+        std::cerr << "No records read from " << input_file << std::endl;
+        return false;
+    }
     std::ofstream file(file_name, std::ios::app);  // Open in append mode
     
     if (!file.is_open()) {
@@ -6,16 +6,48 @@
 #include <fstream>
 #include <string>
 #include "HeaderBuffer.h"
+#include <memory>
 
 using namespace std;
 
 class CSVProcessing {
 public:
+    /**
+     * @brief Creates a processor reading us_postal_codes.csv.
+     */
+    CSVProcessing();
+
+    /**
+     * @brief Creates a processor reading the given CSV file.
+     *
+     * The file is parsed on first use and the parsed Buffer is kept for every later report.
+     *
+     * @param input_file The path to the CSV file to process.
+     */
+    explicit CSVProcessing( const string& input_file );
+
+    /**
+     * @brief Creates a processor over an already loaded Buffer.
+     *
+     * Several processors can share one Buffer, so a single parse feeds all of their reports.
+     *
+     * @param buffer A Buffer filled by read_csv.
+     */
+    explicit CSVProcessing( std::shared_ptr<const Buffer> buffer );
+
+    /**
+     * @brief Gets the CSV file this processor reports on.
+     *
+     * @return The path to the input CSV file.
+     */
+    const string& getInputFile() const { return input_file; }
+
     /**
      * @brief Sorts the CSV buffer and finds the zip codes (eastmost, westmost, northmost, southmost) for each state.
      *
      * This method reads the CSV data, processes it to identify the easternmost, westernmost, northernmost,
      * and southernmost zip codes for each state, and then stores these in a map (automatically sorts alphebetically).
+     * Results are cached by ResultCache, so an unchanged input file is not parsed again.
      *
      * @return A map where the key is the state ID and the value is a vector containing the four ZipCodeRecord. The output looks as follows:
      * [stateID] : {
@@ -49,6 +81,12 @@ public:
      * @return true if the data was successfully written to the file, false otherwise.
      */
     bool csvOutput( string& file_name ); // fill from the sortered buffer? either output as we go from the buffer or create an array or vector to put all the sorting and then output to the csv
+
+private:
+    string input_file;                     // CSV file the reports are computed from
+    std::shared_ptr<const Buffer> buffer;  // Parsed input, shared with other processors; loaded on first use
+
+    static map<string, vector<ZipCodeRecord>> findDirections( const Buffer& CSVBuffer );
 };
 
 #endif
\ No newline at end of file
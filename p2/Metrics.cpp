@@ -0,0 +1,223 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static std::atomic<uint64_t> counters[ static_cast<size_t>( Counter::Count ) ];        // By Counter
+static LatencyHistogram histograms[ static_cast<size_t>( Histogram::Count ) ];         // By Histogram
+
+/**
+ * @brief Creates an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+/**
+ * @brief Finds the bucket holding a value.
+ *
+ * @param value The value to place.
+ * @return The index of its bucket.
+ */
+size_t LatencyHistogram::bucketOf( uint64_t value ) {
+    if ( value < EXACT ) {
+        return static_cast<size_t>( value );
+    }
+    int highestBit = 63 - __builtin_clzll( value );  // At least 7
+    int shift = highestBit - 6;
+    return EXACT + static_cast<size_t>( highestBit - 7 ) * SUB_BUCKETS + static_cast<size_t>( ( value >> shift ) - SUB_BUCKETS );
+}
+
+/**
+ * @brief Gets the largest value a bucket holds.
+ *
+ * @param bucket The index of the bucket.
+ * @return Its largest value.
+ */
+uint64_t LatencyHistogram::highestIn( size_t bucket ) {
+    if ( bucket < EXACT ) {
+        return bucket;
+    }
+    size_t octave = ( bucket - EXACT ) / SUB_BUCKETS;
+    uint64_t sub = ( bucket - EXACT ) % SUB_BUCKETS + SUB_BUCKETS;
+    return ( ( sub + 1 ) << ( octave + 1 ) ) - 1;
+}
+
+/**
+ * @brief Adds one value.
+ *
+ * @param value The value to add.
+ */
+void LatencyHistogram::record( uint64_t value ) {
+    buckets[ bucketOf( value ) ].fetch_add( 1, std::memory_order_relaxed );
+    total.fetch_add( 1, std::memory_order_relaxed );
+    sum.fetch_add( value, std::memory_order_relaxed );
+    uint64_t seen = smallest.load( std::memory_order_relaxed );
+    while ( value < seen && !smallest.compare_exchange_weak( seen, value, std::memory_order_relaxed ) ) {
+    }
+    seen = largest.load( std::memory_order_relaxed );
+    while ( value > seen && !largest.compare_exchange_weak( seen, value, std::memory_order_relaxed ) ) {
+    }
+}
+
+/**
+ * @brief Gets the value below which a fraction of the recorded values fall.
+ *
+ * @param fraction Fraction between 0 and 1, e.g. 0.99 for p99.
+ * @return The largest value of the bucket holding that rank, or 0 if empty.
+ */
+uint64_t LatencyHistogram::percentile( double fraction ) const {
+    uint64_t recorded = count();
+    if ( recorded == 0 ) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>( std::ceil( fraction * recorded ) );
+    rank = rank == 0 ? 1 : rank;
+    uint64_t seen = 0;
+    for ( size_t bucket = 0; bucket < BUCKETS; bucket++ ) {
+        seen += buckets[ bucket ].load( std::memory_order_relaxed );
+        if ( seen >= rank ) {
+            return std::min( highestIn( bucket ), maximum() );
+        }
+    }
+    return maximum();
+}
+
+/**
+ * @brief Gets the smallest recorded value.
+ *
+ * @return The smallest value, or 0 if empty.
+ */
+uint64_t LatencyHistogram::minimum() const {
+    return count() ? smallest.load( std::memory_order_relaxed ) : 0;
+}
+
+/**
+ * @brief Gets the mean of the recorded values.
+ *
+ * @return The mean, or 0 if empty.
+ */
+double LatencyHistogram::mean() const {
+    uint64_t recorded = count();
+    return recorded ? static_cast<double>( sum.load( std::memory_order_relaxed ) ) / recorded : 0.0;
+}
+
+/**
+ * @brief Forgets every recorded value.
+ */
+void LatencyHistogram::reset() {
+    for ( std::atomic<uint64_t>& bucket : buckets ) {
+        bucket.store( 0, std::memory_order_relaxed );
+    }
+    total.store( 0, std::memory_order_relaxed );
+    sum.store( 0, std::memory_order_relaxed );
+    smallest.store( UINT64_MAX, std::memory_order_relaxed );
+    largest.store( 0, std::memory_order_relaxed );
+}
+
+void Metrics::increment( Counter counter, uint64_t amount ) {
+    counters[ static_cast<size_t>( counter ) ].fetch_add( amount, std::memory_order_relaxed );
+}
+
+void Metrics::record( Histogram histogram, uint64_t value ) {
+    histograms[ static_cast<size_t>( histogram ) ].record( value );
+}
+
+uint64_t Metrics::counter( Counter counter ) {
+    return counters[ static_cast<size_t>( counter ) ].load( std::memory_order_relaxed );
+}
+
+const LatencyHistogram& Metrics::histogram( Histogram histogram ) {
+    return histograms[ static_cast<size_t>( histogram ) ];
+}
+
+const char* Metrics::name( Counter counter ) {
+    switch ( counter ) {
+        case Counter::RecordsParsed: return "records_parsed";
+        case Counter::RecordReads: return "record_reads";
+        case Counter::IndexLookups: return "index_lookups";
+        case Counter::IndexMisses: return "index_misses";
+        default: return "unknown";
+    }
+}
+
+const char* Metrics::name( Histogram histogram ) {
+    switch ( histogram ) {
+        case Histogram::RecordParse: return "record_parse_ns";
+        case Histogram::RecordRead: return "record_read_ns";
+        case Histogram::IndexLookup: return "index_lookup_ns";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Checks whether the metrics were compiled in.
+ *
+ * @return false if built with ZIPDB_NO_METRICS.
+ */
+bool Metrics::enabled() {
+#ifndef ZIPDB_NO_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Prints every counter and the count, mean, p50, p99, p999 and max of every histogram.
+ *
+ * @param out The stream to print to.
+ */
+void Metrics::print( std::ostream& out ) {
+    if ( !enabled() ) {
+        out << "Metrics were compiled out (ZIPDB_NO_METRICS)." << std::endl;
+        return;
+    }
+    for ( size_t i = 0; i < static_cast<size_t>( Counter::Count ); i++ ) {
+        out << std::left << std::setw( 20 ) << name( static_cast<Counter>( i ) ) << std::right << std::setw( 12 )
+            << counter( static_cast<Counter>( i ) ) << "\n";
+    }
+    out << "\n" << std::left << std::setw( 20 ) << "histogram" << std::right << std::setw( 10 ) << "count"
+        << std::setw( 12 ) << "mean" << std::setw( 10 ) << "p50" << std::setw( 10 ) << "p99" << std::setw( 10 )
+        << "p999" << std::setw( 12 ) << "max" << "\n";
+    for ( size_t i = 0; i < static_cast<size_t>( Histogram::Count ); i++ ) {
+        const LatencyHistogram& values = histogram( static_cast<Histogram>( i ) );
+        out << std::left << std::setw( 20 ) << name( static_cast<Histogram>( i ) ) << std::right << std::setw( 10 )
+            << values.count() << std::setw( 12 ) << std::fixed << std::setprecision( 1 ) << values.mean()
+            << std::setw( 10 ) << values.percentile( 0.50 ) << std::setw( 10 ) << values.percentile( 0.99 )
+            << std::setw( 10 ) << values.percentile( 0.999 ) << std::setw( 12 ) << values.maximum() << "\n";
+    }
+    out.unsetf( std::ios::floatfield );
+}
+
+/**
+ * @brief Writes the same report as print to a file, as one JSON object.
+ *
+ * @param path Path of the file, replaced if it exists.
+ * @return true if successful, false otherwise.
+ */
+bool Metrics::writeJson( const std::string& path ) {
+    std::ofstream out( path, std::ios::trunc );
+    if ( !out.is_open() ) {
+        std::cerr << "Unable to write metrics file: " << path << std::endl;
+        return false;
+    }
+    out << "{\n  \"enabled\": " << ( enabled() ? "true" : "false" ) << ",\n  \"counters\": {";
+    for ( size_t i = 0; i < static_cast<size_t>( Counter::Count ); i++ ) {
+        out << ( i ? ",\n" : "\n" ) << "    \"" << name( static_cast<Counter>( i ) ) << "\": "
+            << counter( static_cast<Counter>( i ) );
+    }
+    out << "\n  },\n  \"histograms\": {";
+    for ( size_t i = 0; i < static_cast<size_t>( Histogram::Count ); i++ ) {
+        const LatencyHistogram& values = histogram( static_cast<Histogram>( i ) );
+        out << ( i ? ",\n" : "\n" ) << "    \"" << name( static_cast<Histogram>( i ) ) << "\": {"
+            << "\"count\": " << values.count() << ", \"min\": " << values.minimum()
+            << ", \"mean\": " << std::fixed << std::setprecision( 1 ) << values.mean()
+            << ", \"p50\": " << values.percentile( 0.50 ) << ", \"p99\": " << values.percentile( 0.99 )
+            << ", \"p999\": " << values.percentile( 0.999 ) << ", \"max\": " << values.maximum() << "}";
+    }
+    out << "\n  }\n}\n";
+    return out.good();
+}
@@ -0,0 +1,151 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Events counted by the metrics layer.
+ */
+enum class Counter : size_t {
+    RecordsParsed,  // CSV lines parsed into records
+    RecordReads,    // Calls to getRecordAtOffset
+    IndexLookups,   // Zip codes looked up in the index file
+    IndexMisses,    // Lookups that found no record
+    Count
+};
+
+/**
+ * @brief Distributions recorded by the metrics layer, all in nanoseconds.
+ */
+enum class Histogram : size_t {
+    RecordParse,  // Parsing of one CSV line
+    RecordRead,   // One getRecordAtOffset call
+    IndexLookup,  // One zip code lookup, index scan and record read
+    Count
+};
+
+/**
+ * @brief Fixed-size log-linear (HDR-style) histogram of non-negative integers.
+ *
+ * Values below 128 are exact, and every power of two above that is split
+ * into 64 buckets, so a percentile is within about 1.6% of the true value.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /**
+     * @brief Adds one value.
+     *
+     * @param value The value to add.
+     */
+    void record( uint64_t value );
+
+    /**
+     * @brief Gets the value below which a fraction of the recorded values fall.
+     *
+     * @param fraction Fraction between 0 and 1, e.g. 0.99 for p99.
+     * @return The largest value of the bucket holding that rank, or 0 if empty.
+     */
+    uint64_t percentile( double fraction ) const;
+
+    uint64_t count() const { return total.load( std::memory_order_relaxed ); }
+    uint64_t maximum() const { return largest.load( std::memory_order_relaxed ); }
+    uint64_t minimum() const;
+    double mean() const;
+
+    /**
+     * @brief Forgets every recorded value.
+     */
+    void reset();
+
+private:
+    static const size_t EXACT = 128;       // Values below this have their own bucket
+    static const size_t SUB_BUCKETS = 64;  // Buckets per power of two above EXACT
+    static const size_t BUCKETS = EXACT + ( 64 - 7 ) * SUB_BUCKETS;
+
+    static size_t bucketOf( uint64_t value );
+    static uint64_t highestIn( size_t bucket );
+
+    std::atomic<uint64_t> buckets[ BUCKETS ];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> smallest;
+    std::atomic<uint64_t> largest;
+};
+
+/**
+ * @brief Process-wide counters and latency histograms of the p2 hot paths.
+ *
+ * Instrumentation goes through the METRICS_* macros, which compile to
+ * nothing when ZIPDB_NO_METRICS is defined (CMake option ZIPDB_METRICS=OFF).
+ */
+class Metrics {
+public:
+    static void increment( Counter counter, uint64_t amount = 1 );
+    static void record( Histogram histogram, uint64_t value );
+    static uint64_t counter( Counter counter );
+    static const LatencyHistogram& histogram( Histogram histogram );
+    static const char* name( Counter counter );
+    static const char* name( Histogram histogram );
+
+    /**
+     * @brief Checks whether the metrics were compiled in.
+     *
+     * @return false if built with ZIPDB_NO_METRICS.
+     */
+    static bool enabled();
+
+    /**
+     * @brief Prints every counter and the count, mean, p50, p99, p999 and max of every histogram.
+     *
+     * @param out The stream to print to.
+     */
+    static void print( std::ostream& out );
+
+    /**
+     * @brief Writes the same report as print to a file, as one JSON object.
+     *
+     * @param path Path of the file, replaced if it exists.
+     * @return true if successful, false otherwise.
+     */
+    static bool writeJson( const std::string& path );
+
+    /**
+     * @brief Records the time from its construction to its destruction into a histogram.
+     */
+    class Timer {
+    public:
+        explicit Timer( Histogram histogram ) : histogram( histogram ), start( std::chrono::steady_clock::now() ) {}
+        ~Timer() {
+            record( histogram, static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start ).count() ) );
+        }
+        Timer( const Timer& ) = delete;
+        Timer& operator=( const Timer& ) = delete;
+
+    private:
+        Histogram histogram;
+        std::chrono::steady_clock::time_point start;
+    };
+};
+
+#define METRICS_CONCAT_( a, b ) a##b
+#define METRICS_CONCAT( a, b ) METRICS_CONCAT_( a, b )
+
+#ifndef ZIPDB_NO_METRICS
+#define METRICS_COUNT( counter, amount ) Metrics::increment( counter, amount )
+#define METRICS_RECORD( histogram, value ) Metrics::record( histogram, value )
+#define METRICS_TIME( histogram ) Metrics::Timer METRICS_CONCAT( metricsTimer, __LINE__ )( histogram )
+#else
+#define METRICS_COUNT( counter, amount ) ( (void)sizeof( amount ) )
+#define METRICS_RECORD( histogram, value ) ( (void)sizeof( value ) )
+#define METRICS_TIME( histogram ) ( (void)0 )
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+#include "ResultCache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+
+std::map<std::string, ResultCache::Entry> ResultCache::memory;
+
+/**
+ * @brief Computes the key of the current version of a file.
+ *
+ * The content is hashed with 64-bit FNV-1a in 64 KiB chunks, which is far
+ * cheaper than parsing and sorting the records.
+ *
+ * @param path Path of the input file.
+ * @param key Receives the key.
+ * @return true if the file could be read, false otherwise.
+ */
+bool ResultCache::fingerprint( const std::string& path, CacheKey& key ) {
+    std::error_code error;
+    key.path = path;
+    key.size = std::filesystem::file_size( path, error );
+    if ( error ) {
+        return false;
+    }
+    auto written = std::filesystem::last_write_time( path, error );
+    if ( error ) {
+        return false;
+    }
+    key.mtime = static_cast<long long>( written.time_since_epoch().count() );
+
+    std::ifstream file( path, std::ios::binary );
+    if ( !file.is_open() ) {
+        return false;
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    std::vector<char> chunk( 1 << 16 );
+    while ( file.read( chunk.data(), chunk.size() ) || file.gcount() > 0 ) {
+        std::streamsize count = file.gcount();
+        for ( std::streamsize i = 0; i < count; i++ ) {
+            hash ^= static_cast<unsigned char>( chunk[ i ] );
+            hash *= 1099511628211ULL;
+        }
+    }
+    key.hash = hash;
+    return true;
+}
+
+/**
+ * @brief Gets the sidecar file holding the cached results of an input file.
+ *
+ * @param path Path of the input file.
+ * @return The path of the sidecar file.
+ */
+std::string ResultCache::sidecarPath( const std::string& path ) {
+    return path + ".extremes";
+}
+
+/**
+ * @brief Checks whether two keys describe the same version of the same file.
+ *
+ * @param a First key.
+ * @param b Second key.
+ * @return true if path, size, mtime and hash all match.
+ */
+bool ResultCache::sameVersion( const CacheKey& a, const CacheKey& b ) {
+    return a.path == b.path && a.size == b.size && a.mtime == b.mtime && a.hash == b.hash;
+}
+
+/**
+ * @brief Looks up the results of a file version, in memory first and then in the sidecar.
+ *
+ * The sidecar starts with a "extremes <size> <mtime> <hash>" line, followed by
+ * one tab separated "zip state latitude longitude city" line per record, four
+ * records per state in east, west, north, south order.
+ *
+ * @param key Key of the input file.
+ * @param result Receives the cached map of state to {east, west, north, south} records.
+ * @return true if a result for exactly this version was found, false otherwise.
+ */
+bool ResultCache::lookup( const CacheKey& key, std::map<std::string, std::vector<ZipCodeRecord>>& result ) {
+    auto cached = memory.find( key.path );
+    if ( cached != memory.end() && sameVersion( cached->second.key, key ) ) {
+        result = cached->second.result;
+        return true;
+    }
+
+    std::ifstream file( sidecarPath( key.path ) );
+    if ( !file.is_open() ) {
+        return false;
+    }
+    std::string tag;
+    CacheKey stored;
+    stored.path = key.path;
+    if ( !( file >> tag >> stored.size >> stored.mtime >> std::hex >> stored.hash >> std::dec ) ||
+         tag != "extremes" || !sameVersion( stored, key ) ) {
+        return false;
+    }
+
+    std::map<std::string, std::vector<ZipCodeRecord>> loaded;
+    std::string line;
+    std::getline( file, line );  // Rest of the key line
+    while ( std::getline( file, line ) ) {
+        if ( line.empty() ) continue;
+        std::istringstream fields( line );
+        ZipCodeRecord record;
+        std::string latitude, longitude;
+        if ( !std::getline( fields, record.zip_code, '\t' ) || !std::getline( fields, record.state_id, '\t' ) ||
+             !std::getline( fields, latitude, '\t' ) || !std::getline( fields, longitude, '\t' ) ) {
+            std::cerr << "Ignoring malformed cache file " << sidecarPath( key.path ) << std::endl;
+            return false;
+        }
+        std::getline( fields, record.city );
+        char* latitudeEnd = nullptr;
+        char* longitudeEnd = nullptr;
+        record.latitude = std::strtod( latitude.c_str(), &latitudeEnd );
+        record.longitude = std::strtod( longitude.c_str(), &longitudeEnd );
+        if ( *latitudeEnd != '\0' || *longitudeEnd != '\0' ) {
+            std::cerr << "Ignoring malformed cache file " << sidecarPath( key.path ) << std::endl;
+            return false;
+        }
+        loaded[ record.state_id ].push_back( record );
+    }
+    for ( const auto& state : loaded ) {
+        if ( state.second.size() != 4 ) {
+            std::cerr << "Ignoring malformed cache file " << sidecarPath( key.path ) << std::endl;
+            return false;
+        }
+    }
+
+    memory[ key.path ] = { key, loaded };
+    result = std::move( loaded );
+    return true;
+}
+
+/**
+ * @brief Stores the results of a file version in memory and in the sidecar.
+ *
+ * @param key Key of the input file.
+ * @param result Map of state to {east, west, north, south} records.
+ * @return true if the sidecar was written, false otherwise (the memory copy is kept).
+ */
+bool ResultCache::store( const CacheKey& key, const std::map<std::string, std::vector<ZipCodeRecord>>& result ) {
+    memory[ key.path ] = { key, result };
+
+    std::ofstream file( sidecarPath( key.path ), std::ios::trunc );
+    if ( !file.is_open() ) {
+        std::cerr << "Unable to write cache file: " << sidecarPath( key.path ) << std::endl;
+        return false;
+    }
+    file << "extremes " << key.size << " " << key.mtime << " " << std::hex << key.hash << std::dec << "\n";
+    file << std::setprecision( 17 );
+    for ( const auto& [ state, records ] : result ) {
+        for ( const ZipCodeRecord& record : records ) {
+            file << record.zip_code << "\t" << record.state_id << "\t" << record.latitude << "\t"
+                 << record.longitude << "\t" << record.city << "\n";
+        }
+    }
+    return file.good();
+}
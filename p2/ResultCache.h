@@ -0,0 +1,79 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "buffer.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+/**
+ * @brief Identifies one version of an input file.
+ *
+ * Size and modification time catch most edits; the content hash catches
+ * edits that keep both (same-size rewrites within one clock tick).
+ */
+struct CacheKey {
+    std::string path;      // Input file path as given
+    uintmax_t size;        // File size in bytes
+    long long mtime;       // Last write time in file clock ticks
+    uint64_t hash;         // FNV-1a hash of the file content
+};
+
+/**
+ * @brief Caches the per-state extreme zip codes computed from an input file.
+ *
+ * Results live in memory for the rest of the process and in a sidecar file
+ * next to the input ("<input>.extremes"), so later runs on an unchanged
+ * input skip parsing it. A result is only used when path, size, mtime and
+ * content hash all match the current file.
+ */
+class ResultCache {
+public:
+    /**
+     * @brief Computes the key of the current version of a file.
+     *
+     * @param path Path of the input file.
+     * @param key Receives the key.
+     * @return true if the file could be read, false otherwise.
+     */
+    static bool fingerprint( const std::string& path, CacheKey& key );
+
+    /**
+     * @brief Looks up the results of a file version, in memory first and then in the sidecar.
+     *
+     * @param key Key of the input file.
+     * @param result Receives the cached map of state to {east, west, north, south} records.
+     * @return true if a result for exactly this version was found, false otherwise.
+     */
+    static bool lookup( const CacheKey& key, std::map<std::string, std::vector<ZipCodeRecord>>& result );
+
+    /**
+     * @brief Stores the results of a file version in memory and in the sidecar.
+     *
+     * @param key Key of the input file.
+     * @param result Map of state to {east, west, north, south} records.
+     * @return true if the sidecar was written, false otherwise (the memory copy is kept).
+     */
+    static bool store( const CacheKey& key, const std::map<std::string, std::vector<ZipCodeRecord>>& result );
+
+    /**
+     * @brief Gets the sidecar file holding the cached results of an input file.
+     *
+     * @param path Path of the input file.
+     * @return The path of the sidecar file.
+     */
+    static std::string sidecarPath( const std::string& path );
+
+private:
+    struct Entry {
+        CacheKey key;
+        std::map<std::string, std::vector<ZipCodeRecord>> result;
+    };
+
+    static std::map<std::string, Entry> memory;  // Results computed or loaded in this process, by path
+
+    static bool sameVersion( const CacheKey& a, const CacheKey& b );
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "StringPool.h"
+#include <cstring>
+
+/**
+ * @brief Creates an empty pool.
+ */
+StringPool::StringPool() : ids( &storage ) {}
+
+/**
+ * @brief Gets the id of a string, adding the string if it is new.
+ *
+ * @param text The string to intern.
+ * @return The id of the string.
+ */
+uint32_t StringPool::intern( std::string_view text ) {
+    auto found = ids.find( text );
+    if ( found != ids.end() ) {
+        return found->second;
+    }
+    char* copy = static_cast<char*>( storage.allocate( text.size() + 1, 1 ) );
+    std::memcpy( copy, text.data(), text.size() );
+    copy[ text.size() ] = '\0';
+    uint32_t id = static_cast<uint32_t>( values.size() );
+    values.emplace_back( copy, text.size() );
+    ids.emplace( values.back(), id );
+    return id;
+}
+
+/**
+ * @brief Looks up the id of a string without adding it.
+ *
+ * @param text The string to look up.
+ * @param id Receives the id if the string is in the pool.
+ * @return true if the string is in the pool, false otherwise.
+ */
+bool StringPool::find( std::string_view text, uint32_t& id ) const {
+    auto found = ids.find( text );
+    if ( found == ids.end() ) {
+        return false;
+    }
+    id = found->second;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory_resource>
+#include <cstdint>
+
+/**
+ * @brief Interning table mapping each distinct string to a 32-bit id.
+ *
+ * Repeated field values (states, cities) are stored once, and records keep
+ * the id instead of their own copy, so grouping and equality tests compare
+ * integers. Ids are dense, starting at 0, and never change once given out.
+ * A pool can be shared by several Buffers so their ids agree.
+ */
+class StringPool {
+public:
+    StringPool();
+
+    // Views handed out point into the pool's own storage
+    StringPool( const StringPool& ) = delete;
+    StringPool& operator=( const StringPool& ) = delete;
+
+    /**
+     * @brief Gets the id of a string, adding the string if it is new.
+     *
+     * @param text The string to intern.
+     * @return The id of the string.
+     */
+    uint32_t intern( std::string_view text );
+
+    /**
+     * @brief Looks up the id of a string without adding it.
+     *
+     * @param text The string to look up.
+     * @param id Receives the id if the string is in the pool.
+     * @return true if the string is in the pool, false otherwise.
+     */
+    bool find( std::string_view text, uint32_t& id ) const;
+
+    /**
+     * @brief Gets the string with a given id.
+     *
+     * @param id An id returned by intern.
+     * @return The string, valid for the life of the pool.
+     */
+    std::string_view text( uint32_t id ) const { return values[ id ]; }
+
+    /**
+     * @brief Gets the number of distinct strings.
+     *
+     * @return The number of strings; every id is below it.
+     */
+    size_t size() const { return values.size(); }
+
+private:
+    std::pmr::monotonic_buffer_resource storage;                     // Text and hash nodes, freed with the pool
+    std::vector<std::string_view> values;                            // Strings by id, viewing storage
+    std::pmr::unordered_map<std::string_view, uint32_t> ids;         // Views into storage, to their ids
+};
+
+#endif
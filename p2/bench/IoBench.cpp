@@ -0,0 +1,60 @@
+/**
+ * @file IoBench.cpp
+ * @brief Throughput of the p2 I/O paths on 1x, 10x and 100x datasets.
+ *
+ * Covers Buffer::read_csv, convertCSVToLengthIndicated and
+ * IndexFile::createIndexFile. Outputs are written next to the scaled
+ * datasets in the work directory. Built and run by the `bench` target of
+ * the top level CMake build:
+ *     cmake -S . -B build && cmake --build build --target bench
+ *
+ * Or directly, with a subset of the scales:
+ *     ./build/p2/p2_io_bench --data=p2/us_postal_codes.csv --scales=1,10
+ *
+ * @date 10/18/2026
+ */
+
+#include "BenchHarness.h"
+#include "buffer.h"
+#include "CSVLengthIndicated.h"
+#include "IndexFile.h"
+#include <string>
+
+int main( int argc, char* argv[] ) {
+    BenchOptions options;
+    if ( !parseBenchOptions( argc, argv, options ) ) {
+        return 1;
+    }
+    BenchRunner runner( options );
+
+    for ( int scale : options.scales ) {
+        std::string tag = "/" + std::to_string( scale ) + "x";
+        std::string base = options.workDir + "/us_postal_codes_" + std::to_string( scale ) + "x";
+        std::string csvFile = base + ".csv";
+        size_t records = 0;
+        if ( !makeScaledCsv( options.dataFile, csvFile, scale, records ) ) {
+            return 1;
+        }
+        size_t csvBytes = fileBytes( csvFile );
+
+        runner.run( "Buffer::read_csv" + tag, records, csvBytes, [ & ] {
+            Buffer buffer;
+            buffer.read_csv( csvFile );
+        } );
+
+        runner.run( "convertCSVToLengthIndicated" + tag, records, csvBytes, [ & ] {
+            convertCSVToLengthIndicated( csvFile, base + "_length_indicated.txt" );
+        } );
+
+        // The index is built from the length indicated file written above
+        std::string lengthIndicatedFile = base + "_length_indicated.txt";
+        if ( fileBytes( lengthIndicatedFile ) == 0 ) {
+            runner.prepare( [ & ] { convertCSVToLengthIndicated( csvFile, lengthIndicatedFile ); } );
+        }
+        runner.run( "IndexFile::createIndexFile" + tag, records, fileBytes( lengthIndicatedFile ), [ & ] {
+            IndexFile index;
+            index.createIndexFile( lengthIndicatedFile, base + "_index.txt" );
+        } );
+    }
+    return 0;
+}
@@ -1,7 +1,13 @@
 // Buffer.cpp
 #include "buffer.h"
+#include "Metrics.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
 
 /**
  * @file Buffer.cpp
@@ -16,28 +22,66 @@
  * 9/29/2024
  */
 
+/**
+ * @brief Creates an empty Buffer.
+ * 
+ * @param strings Pool for the city and state names; a new one if null. 
+ *        Buffers sharing a pool give equal names equal ids.
+ */
+Buffer::Buffer(std::shared_ptr<StringPool> strings)
+    : strings(strings ? std::move(strings) : std::make_shared<StringPool>()) {}
+
 /**
  * @brief Reads the CSV file and stores the zip code records.
  * 
  * This function opens the CSV file, reads its contents, and 
  * parses each line into a ZipCodeRecord, which is stored in a vector.
  * 
- * @param file_name The path to the CSV file (us_postal_codes.csv).
+ * Records from an earlier call are replaced, so one Buffer can be reloaded.
+ * 
+ * @param file_name The path to the CSV file (us_postal_codes.csv by default).
  * @return True if the file is read successfully, false otherwise.
  */
-bool Buffer::read_csv() {
-    std::ifstream file("us_postal_codes.csv"); // Open the file
+bool Buffer::read_csv(const std::string& file_name) {
+    std::ifstream file(file_name); // Open the file
     if (!file.is_open()) {
-        std::cerr << "Error opening file: us_postal_codes.csv" << std::endl;
+        std::cerr << "Error opening file: " << file_name << std::endl;
         return false;
     }
+    records.clear();
+    state_index.clear();
+    source_file = file_name;
+
+    // The text kept is never larger than the file, so sizing the arena's first
+    // chunk by the file size usually makes the whole load one allocation
+    std::error_code error;
+    uintmax_t file_size = std::filesystem::file_size(file_name, error);
+    arena = std::make_unique<std::pmr::monotonic_buffer_resource>(error || file_size == 0 ? 4096 : file_size);
 
     std::string line;
     std::getline(file, line); // Skip the header line
 
-    // Read each line of the file
+    // Read each line of the file, grouping positions by state id
+    std::vector<std::vector<size_t>> positions_by_state;
     while (std::getline(file, line)) {
         records.push_back(parse_csv_line(line)); // Parse and store the line
+        uint32_t state = records.back().state_id;
+        if (state >= positions_by_state.size()) {
+            positions_by_state.resize(state + 1);
+        }
+        positions_by_state[state].push_back(records.size() - 1);
+    }
+
+    // Keep each state's positions in zip code order; stored fields are null terminated
+    for (uint32_t state = 0; state < positions_by_state.size(); state++) {
+        std::vector<size_t>& positions = positions_by_state[state];
+        if (positions.empty()) {
+            continue;
+        }
+        std::stable_sort(positions.begin(), positions.end(), [this](size_t a, size_t b) {
+            return std::atol(records[a].zip_code.data()) < std::atol(records[b].zip_code.data());
+        });
+        state_index.emplace(std::string(strings->text(state)), std::move(positions));
     }
 
     file.close(); // Close the file
@@ -49,70 +93,147 @@ bool Buffer::read_csv() {
  * @brief Groups the Zip Code records by state.
  * 
  * This function organizes the Zip Code records into a map where each 
- * state ID is a key, and the value is a vector of ZipCodeRecord 
- * structures associated with that state.
+ * state ID is a key, and the value is a vector of pointers to the 
+ * records of that state. The records are not copied; the pointers stay 
+ * valid until the Buffer is reloaded or destroyed.
  * 
- * @return A map with state IDs as keys and vectors of ZipCodeRecord 
- *         structures as values.
+ * @return A map with state IDs as keys and vectors of record pointers, 
+ *         sorted by zip code, as values.
  */
-std::map<std::string, std::vector<ZipCodeRecord>> Buffer::get_state_zip_codes() const {
-    std::map<std::string, std::vector<ZipCodeRecord>> state_zip_map; // Create a map to hold state records
+std::map<std::string, std::vector<const ZipCodeRecordView*>> Buffer::get_state_zip_codes() const {
+    std::map<std::string, std::vector<const ZipCodeRecordView*>> state_zip_map; // Create a map to hold state records
     
-    // Loop through all records
-    for (const auto& record : records) {
-        state_zip_map[record.state_id].push_back(record); // Add record to the correct state
+    // Point at each state's records through the state index
+    for (const auto& entry : state_index) {
+        std::vector<const ZipCodeRecordView*>& state_records = state_zip_map[entry.first];
+        state_records.reserve(entry.second.size());
+        for (size_t position : entry.second) {
+            state_records.push_back(&records[position]); // Add record to the correct state
+        }
     }
 
     return state_zip_map; // Return the grouped records
 }
 
 /**
- * @brief Parses a line from the CSV into a ZipCodeRecord.
+ * @brief Gets the secondary index from state to records.
+ * 
+ * The index is built once by read_csv, so per-state scans read the records in 
+ * place instead of copying them into a new map.
+ * 
+ * @return A map with state IDs as keys and positions in get_records(), 
+ *         sorted by zip code, as values.
+ */
+const std::map<std::string, std::vector<size_t>>& Buffer::get_state_index() const {
+    return state_index;
+}
+
+/**
+ * @brief Gets the file the records were read from.
+ * 
+ * @return The path given to the last successful read_csv, or an empty string.
+ */
+const std::string& Buffer::get_file_name() const {
+    return source_file;
+}
+
+/**
+ * @brief Gets all Zip Code records in the order they were read.
+ * 
+ * @return The records read by read_csv, viewing text owned by this Buffer.
+ */
+const std::vector<ZipCodeRecordView>& Buffer::get_records() const {
+    return records;
+}
+
+/**
+ * @brief Gets the pool holding the city and state names of the records.
+ * 
+ * @return The pool; ZipCodeRecordView::city and state_id are ids in it.
+ */
+const StringPool& Buffer::get_strings() const {
+    return *strings;
+}
+
+/**
+ * @brief Copies a record out of the Buffer that read it.
+ * 
+ * @param record A record of this Buffer.
+ * @return A ZipCodeRecord owning copies of the text.
+ */
+ZipCodeRecord Buffer::to_record(const ZipCodeRecordView& record) const {
+    return { std::string(record.zip_code), std::string(strings->text(record.city)),
+             std::string(strings->text(record.state_id)), record.latitude, record.longitude };
+}
+
+/**
+ * @brief Copies a field into the arena.
+ * 
+ * The copy is followed by a null character, so its data() can be passed to 
+ * C functions such as atol.
+ * 
+ * @param text The field to copy.
+ * @return A view of the copy, valid until the Buffer is reloaded or destroyed.
+ */
+std::string_view Buffer::store(std::string_view text) {
+    char* copy = static_cast<char*>(arena->allocate(text.size() + 1, 1));
+    std::memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    return std::string_view(copy, text.size());
+}
+
+/**
+ * @brief Parses a line from the CSV into a ZipCodeRecordView.
  * 
  * This function takes a single line of CSV data and extracts the 
- * Zip Code, city, state ID, latitude, and longitude to populate a 
- * ZipCodeRecord structure.
+ * Zip Code, city, state ID, latitude, and longitude. The zip code is 
+ * copied into the arena and the city and state are interned; the line 
+ * itself is not kept.
  * 
  * @param line A string representing a single line from the CSV file.
- * @return A ZipCodeRecord structure containing the parsed data.
+ * @return A ZipCodeRecordView viewing the stored fields.
  */
-ZipCodeRecord Buffer::parse_csv_line(const std::string& line) const {
-    std::stringstream ss(line); // Use stringstream to parse the line
-    ZipCodeRecord record; // Create a ZipCodeRecord to hold the data
-    std::string skip;
+ZipCodeRecordView Buffer::parse_csv_line(const std::string& line) {
+    METRICS_TIME(Histogram::RecordParse);
+    METRICS_COUNT(Counter::RecordsParsed, 1);
+    std::string_view rest(line);
+    auto next_field = [&rest]() {
+        size_t comma = rest.find(',');
+        std::string_view field = rest.substr(0, comma);
+        rest = (comma == std::string_view::npos) ? std::string_view() : rest.substr(comma + 1);
+        return field;
+    };
 
     // Extract and store each field
-    std::getline(ss, record.zip_code, ','); // Get Zip Code
-    std::getline(ss, record.city, ',');     // Get City
-    std::getline(ss, record.state_id, ','); // Get State ID
-    std::getline(ss, skip, ',');            // Skip a field
-    std::string latitude_str, longitude_str;
-    std::getline(ss, latitude_str, ',');    // Get Latitude as string
-    std::getline(ss, longitude_str, ',');   // Get Longitude as string
-    
-    try {
-        if (!latitude_str.empty()) {
-            record.latitude = std::stod(latitude_str); // Convert to double
-        } else {
-            std::cerr << "Invalid latitude value for Zip Code: " << record.zip_code << std::endl;
-            record.latitude = 0.0; // Default value or handle appropriately
-        }
+    ZipCodeRecordView record;
+    record.zip_code = store(next_field());          // Get Zip Code
+    record.city = strings->intern(next_field());     // Get City
+    record.state_id = strings->intern(next_field()); // Get State ID
+    next_field();                          // Skip a field
+    std::string latitude_str(next_field());  // Get Latitude as string
+    std::string longitude_str(next_field()); // Get Longitude as string
 
-        if (!longitude_str.empty()) {
-            record.longitude = std::stod(longitude_str); // Convert to double
-        } else {
-            std::cerr << "Invalid longitude value for Zip Code: " << record.zip_code << std::endl;
-            record.longitude = 0.0; // Default value or handle appropriately
+    // Converts a coordinate the way std::stod would, reporting problems the same way
+    auto to_coordinate = [this, &record](const std::string& text, const char* name) {
+        if (text.empty()) {
+            std::cerr << "Invalid " << name << " value for Zip Code: " << record.zip_code << std::endl;
+            return 0.0; // Default value or handle appropriately
         }
-    } catch (const std::invalid_argument& e) {
-        std::cerr << "Error: Invalid numeric value in CSV for Zip Code: " << record.zip_code << " " << record.state_id << std::endl;
-        record.latitude = 0.0;  // Default value or handle appropriately
-        record.longitude = 0.0; // Default value or handle appropriately
-    } catch (const std::out_of_range& e) {
-        std::cerr << "Error: Out of range numeric value in CSV for Zip Code: " << record.zip_code << std::endl;
-        record.latitude = 0.0;  // Default value or handle appropriately
-        record.longitude = 0.0; // Default value or handle appropriately
-    }
+        char* end = nullptr;
+        errno = 0;
+        double value = std::strtod(text.c_str(), &end);
+        if (end == text.c_str()) {
+            std::cerr << "Error: Invalid numeric value in CSV for Zip Code: " << record.zip_code << " " << strings->text(record.state_id) << std::endl;
+            return 0.0; // Default value or handle appropriately
+        }
+        if (errno == ERANGE) {
+            std::cerr << "Error: Out of range numeric value in CSV for Zip Code: " << record.zip_code << std::endl;
+            return 0.0; // Default value or handle appropriately
+        }
+        return value;
+    };
+    record.latitude = to_coordinate(latitude_str, "latitude");
+    record.longitude = to_coordinate(longitude_str, "longitude");
 
     return record; // Return the populated record
 }
@@ -5,6 +5,11 @@
 #include <vector>
 #include <map>
 #include <fstream>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include "StringPool.h"
 
 // Define ZipCodeRecord structure
 struct ZipCodeRecord {
@@ -15,24 +20,67 @@ struct ZipCodeRecord {
     double longitude;
 };
 
+// A ZipCodeRecord as kept by a Buffer: the zip code lives in the Buffer's arena,
+// city and state are ids in its StringPool; valid until the Buffer is destroyed or reloaded
+struct ZipCodeRecordView {
+    std::string_view zip_code;
+    uint32_t city;
+    uint32_t state_id;
+    double latitude;
+    double longitude;
+};
+
 // Define Buffer class
 class Buffer {
 public:
-    // Method to read a CSV file and store records
-    bool read_csv();
+    // Constructor; Buffers given the same pool share city and state ids
+    explicit Buffer(std::shared_ptr<StringPool> strings = nullptr);
+
+    // Method to read a CSV file and store records, replacing any read before
+    bool read_csv(const std::string& file_name = "us_postal_codes.csv");
+
+    // Method to get the file the records were read from
+    const std::string& get_file_name() const;
+
+    // Method to get records grouped by state, pointing into this Buffer
+    std::map<std::string, std::vector<const ZipCodeRecordView*>> get_state_zip_codes() const;
+
+    // Method to get the secondary index from state ID to record positions, sorted by zip code
+    const std::map<std::string, std::vector<size_t>>& get_state_index() const;
 
-    // Method to get records grouped by state
-    std::map<std::string, std::vector<ZipCodeRecord>> get_state_zip_codes() const;
+    // Method to get all records in file order; their text is owned by this Buffer
+    const std::vector<ZipCodeRecordView>& get_records() const;
+
+    // Method to get the pool holding the city and state names
+    const StringPool& get_strings() const;
+
+    // Method to copy a record out of the Buffer, for results that outlive it
+    ZipCodeRecord to_record(const ZipCodeRecordView& record) const;
 
     // Method to read and unpack a length-indicated Zip Code record
     bool readLengthIndicatedRecord(std::ifstream &fileStream, ZipCodeRecord &record);
 
 private:
-    // Vector to store ZipCodeRecord entries
-    std::vector<ZipCodeRecord> records;
+    // File the records were read from
+    std::string source_file;
+
+    // Arena owning the text of every record; released in one piece on reload or destruction
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+
+    // Interned city and state names, possibly shared with other Buffers
+    std::shared_ptr<StringPool> strings;
+
+    // Vector to store record entries, viewing text in the arena
+    std::vector<ZipCodeRecordView> records;
+
+    // Positions in records of the zip codes of each state, kept by read_csv
+    std::map<std::string, std::vector<size_t>> state_index;
+
+    // Method to parse a line from CSV into a record, copying its text into the arena
+    ZipCodeRecordView parse_csv_line(const std::string& line);
 
-    // Method to parse a line from CSV into ZipCodeRecord
-    ZipCodeRecord parse_csv_line(const std::string& line) const;
+    // Method to copy a field into the arena
+    std::string_view store(std::string_view text);
 };
 
 #endif
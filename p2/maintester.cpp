@@ -16,20 +16,21 @@
 #include <iostream>
 #include <fstream>
 #include "IndexFile.h"
+#include "Metrics.h"
 using namespace std;
 /**
  * @brief Converts and sorts CSV data to a specified output file
- * @param origin CSVProcessing object that handles the CSV operations
+ * @param origin CSVProcessing object that handles the CSV operations; keeps its parsed input for later reports
  * @param file Output file name where the processed CSV will be saved
  * @details Generates a header row and processes the CSV data, reporting any errors encountered during the operation
  */
 /**
  * @brief Converts and sorts CSV data to a specified output file
- * @param origin CSVProcessing object that handles the CSV operations
+ * @param origin CSVProcessing object that handles the CSV operations; keeps its parsed input for later reports
  * @param file Output file name where the processed CSV will be saved
  * @details Generates a header row and processes the CSV data, reporting any errors encountered during the operation
  */
-void csvConvert_sort( CSVProcessing origin, string file ) {
+void csvConvert_sort( CSVProcessing& origin, string file ) {
     cout << "Generating header row." << endl;
     origin.addHeader( file );  // Generate the header for the CSV file
     cout << "Checking for errors" << endl << "Errors: ";
@@ -101,6 +102,8 @@ std::vector<std::string> splitZipLine(const std::string& str) {
  *          and reads one line from that position
  */
 std::string getRecordAtOffset(const std::string& filename, int offset) {
+    METRICS_TIME( Histogram::RecordRead );
+    METRICS_COUNT( Counter::RecordReads, 1 );
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open data file.");
@@ -132,6 +135,8 @@ std::string getRecordAtOffset(const std::string& filename, int offset) {
  *          if zip code is not found
  */
 void check( const std::string& str, const std::string& outputfile, const std::string& indexName){
+	METRICS_TIME( Histogram::IndexLookup );
+	METRICS_COUNT( Counter::IndexLookups, 1 );
 	bool notfound = true;
 	std::string correct_line;
 	 std::ifstream file2(indexName); // Open the file add name later
@@ -166,6 +171,7 @@ void check( const std::string& str, const std::string& outputfile, const std::st
 			}
 			
 	if(notfound){
+			METRICS_COUNT( Counter::IndexMisses, 1 );
 			cout<< str << " was not found in the index.";
 			}
 			file2.close();
@@ -179,19 +185,32 @@ void check( const std::string& str, const std::string& outputfile, const std::st
  *          3. Creates an index file for zip code lookup
  *          4. Accepts user input for zip codes to look up
  *          5. Processes and displays information for requested zip codes
+ *          6. Writes the metrics as JSON if started with --metrics-json=<file>
  */
 
-int main() {
-    CSVProcessing csvProcessor;
+int main( int argc, char* argv[] ) {
+    std::string metricsFile;
+    for ( int i = 1; i < argc; i++ ) {
+        std::string argument = argv[ i ];
+        if ( argument.rfind( "--metrics-json=", 0 ) == 0 ) {
+            metricsFile = argument.substr( argument.find( '=' ) + 1 );
+        } else {
+            std::cerr << "Usage: " << argv[ 0 ] << " [--metrics-json=<file>]" << std::endl;
+            return 1;
+        }
+    }
+
     std::string csvFileName1 = "us_postal_codes.csv";              // Input CSV file 1
     std::string csvFileName2 = "us_postal_codes_ROWS_RANDOMIZED.csv";  // Input CSV file 2
     std::string outputFileName1 = "output1.csv";                   // Output CSV file 1
     std::string outputFileName2 = "output2.csv";                   // Output CSV file 2
+    CSVProcessing csvProcessor1( csvFileName1 );
+    CSVProcessing csvProcessor2( csvFileName2 );
 
     // Step 1: Convert and sort both CSV files
     cout << "Processing and sorting both CSV files." << endl;
-    csvConvert_sort( csvProcessor, outputFileName1 );
-    csvConvert_sort( csvProcessor, outputFileName2 );
+    csvConvert_sort( csvProcessor1, outputFileName1 );
+    csvConvert_sort( csvProcessor2, outputFileName2 );
 
     // Step 2: Convert both CSV files to length-indicated format (ASCII)
     cout << "\nConverting both CSVs to length-indicated format (ASCII)." << endl;
@@ -216,6 +235,9 @@ int main() {
 		//check(str,output1);
 		check(str,output1, indexName );
     }
-    
+
+    if ( !metricsFile.empty() && !Metrics::writeJson( metricsFile ) ) {
+        return 1;
+    }
     return 0;
 }
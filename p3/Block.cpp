@@ -4,7 +4,25 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "HeaderRecord.h"
+#include "WriteAheadLog.h"
+#include "BloomFilter.h"
+#include "HilbertCurve.h"
+#include "StateExtremes.h"
+#include "Metrics.h"
+#include "FileFingerprint.h"
+#include "Crc32c.h"
+#include "ReadAhead.h"
 
 using namespace std;
 
@@ -29,119 +47,1209 @@ int listHeadRBN = -1;
  */
 int availHeadRBN = -1;
 
+/**
+ * @brief Interned city, state and other repeated field values.
+ */
+StringPool fieldStrings;
+
+/**
+ * @brief Redo log receiving every block mutation, if one has been opened.
+ */
+static unique_ptr<WriteAheadLog> blockLog;
+
+/**
+ * @brief Block file protected by the redo log.
+ */
+static string blockLogFile;
+
+/**
+ * @brief True once the header of the logged block file has been marked stale.
+ */
+static bool blockFileStale = false;
+
+/**
+ * @brief Bloom filter of the index file `search` last used, loaded from `<index>.bloom`.
+ */
+static BloomFilter searchFilter;
+
+/**
+ * @brief Index file whose filter is in `searchFilter`; empty until the first search.
+ */
+static string searchFilterIndex;
+
+/**
+ * @brief Zip codes installed by `updateBlock` and their blocks, which no index or filter file has seen yet.
+ */
+static map<int, int> updatedZips;
+
+/**
+ * @brief Block file opened by `openBlockFile`, read by `materializeBlock` for blocks not yet loaded.
+ */
+static int lazyBlockFd = -1;
+
+/**
+ * @brief Background reader fetching the blocks a scan will visit next from `lazyBlockFd`.
+ */
+static unique_ptr<ReadAhead> blockReadAhead;
+
+/**
+ * @brief Number of blocks a scan keeps requested ahead of the one it is on; see `setBlockReadAhead`.
+ */
+static size_t readAheadDepth = 256;
+
+/**
+ * @brief Position of one block line in a block file.
+ */
+struct BlockExtent {
+    int32_t RBN;      ///< Relative Block Number of the block
+    uint32_t length;  ///< Line length in bytes, without the newline
+    int64_t offset;   ///< Position of the start of the line
+};
+
+/**
+ * @brief First bytes of a block offsets sidecar.
+ */
+static const char OFFSETS_MAGIC[8] = {'B', 'L', 'K', 'O', 'F', 'F', '0', '2'};
+
+/**
+ * @brief How block checksums are checked when blocks are read from disk; see `setBlockVerifyMode`.
+ */
+static BlockVerifyMode verifyMode = BlockVerifyMode::Always;
+
+/**
+ * @brief In sampled mode, one block read in this many is checked.
+ */
+static unsigned verifySampleInterval = 16;
+
+/**
+ * @brief Block reads seen in sampled mode.
+ */
+static atomic<uint64_t> verifySampleCount{0};
+
+/**
+ * @brief Extreme zip codes of every state over the active blocks.
+ * 
+ * Built from the blocks on first use, then kept current by `updateBlock` and
+ * `createBlock` so `listMost` does not rescan the file.
+ */
+static StateExtremes stateExtremes;
+
+/**
+ * @brief True once `stateExtremes` has been built from the blocks.
+ */
+static bool stateExtremesBuilt = false;
+
+/**
+ * @brief Builds the header record describing a blocked sequence set file.
+ * 
+ * @return The header with the default block file settings and field definitions.
+ */
+static HeaderRecord makeBlockHeader() {
+    HeaderRecord header;
+
+    // Set basic header information
+    header.setFileStructureType("blocked_sequence_set");
+    header.setVersion("1.0");
+    header.setBlockSize(512);  // Default block size
+    header.setMinBlockCapacity(0.5);  // 50% minimum capacity
+    header.setIndexFileName("headerTest.idx");
+    header.setIndexSchema("key:string,rbn:int");
+
+    // Add field definitions
+    header.addField("zip_code", "string(5)");
+    header.addField("place_name", "string(64)");
+    header.addField("state", "string(2)");
+    header.addField("county", "string(64)");
+    header.addField("latitude", "decimal(8,4)");
+    header.addField("longitude", "decimal(8,4)");
+
+    // Set primary key field (zip_code is field 0)
+    header.setPrimaryKeyField(0);
+    return header;
+}
+
+/**
+ * @brief Writes one block as a line of the block file.
+ * 
+ * The line is `RBN#checksum:payload`, where the checksum is the CRC-32C of
+ * the payload as eight hex digits.
+ * 
+ * @param outFile Stream to write to.
+ * @param RBN Relative Block Number of the block.
+ * @param payload Raw or encoded records of the block.
+ * @param extents Receives the position of the line, if not null.
+ */
+static void writeBlockLine(ostream& outFile, int RBN, const string& payload, vector<BlockExtent>* extents = nullptr) {
+    METRICS_COUNT(Counter::BlockWrites, 1);
+    char prefix[32];
+    int prefixLength = snprintf(prefix, sizeof(prefix), "%d#%08x:", RBN, crc32c(0, payload.data(), payload.size()));
+    if (extents) {
+        int64_t start = static_cast<int64_t>(outFile.tellp());
+        extents->push_back({RBN, static_cast<uint32_t>(prefixLength + payload.size()), start});
+    }
+    outFile.write(prefix, prefixLength);
+    outFile << payload << "\n";
+}
+
+/**
+ * @brief Splits a block file line into its RBN, checksum and payload.
+ * 
+ * Lines written before blocks carried checksums are `RBN:payload` and are
+ * accepted without one.
+ * 
+ * @param line Line of the block file.
+ * @param RBN Receives the Relative Block Number.
+ * @param checksum Receives the checksum, if the line has one.
+ * @param hasChecksum Receives whether the line has a checksum.
+ * @return Position of the payload in the line, or string::npos if the line is malformed.
+ */
+static size_t parseBlockLine(const string& line, int& RBN, uint32_t& checksum, bool& hasChecksum) {
+    const char* start = line.c_str();
+    char* end = nullptr;
+    long number = strtol(start, &end, 10);
+    if (end == start) {
+        return string::npos;
+    }
+    RBN = static_cast<int>(number);
+    hasChecksum = *end == '#';
+    if (hasChecksum) {
+        const char* digits = end + 1;
+        checksum = static_cast<uint32_t>(strtoul(digits, &end, 16));
+        if (end != digits + 8) {
+            return string::npos;
+        }
+    }
+    return *end == ':' ? static_cast<size_t>(end - start) + 1 : string::npos;
+}
+
+/**
+ * @brief Tells whether the block read now should have its checksum checked, following the verify mode.
+ * 
+ * @return True if the checksum should be checked, false otherwise.
+ */
+static bool shouldVerifyBlock() {
+    switch (verifyMode) {
+        case BlockVerifyMode::Always: return true;
+        case BlockVerifyMode::Sampled: return verifySampleCount.fetch_add(1, memory_order_relaxed) % verifySampleInterval == 0;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Checks a block payload against the checksum of its line.
+ * 
+ * @param RBN Relative Block Number of the block, for the error message.
+ * @param payload Payload of the block.
+ * @param length Payload length in bytes.
+ * @param checksum Checksum stored with the block.
+ * @return True if the payload matches its checksum, false otherwise.
+ */
+static bool blockChecksumMatches(int RBN, const char* payload, size_t length, uint32_t checksum) {
+    METRICS_COUNT(Counter::ChecksumVerifies, 1);
+    if (crc32c(0, payload, length) == checksum) {
+        return true;
+    }
+    METRICS_COUNT(Counter::ChecksumFailures, 1);
+    cerr << "Error: Checksum mismatch in block " << RBN << ", the block is corrupted" << endl;
+    return false;
+}
+
+/**
+ * @brief Gets the size and modification time of a file.
+ * 
+ * @param path Path of the file.
+ * @param size Receives the size in bytes.
+ * @param mtime Receives the modification time in nanoseconds.
+ * @return True if the file exists, false otherwise.
+ */
+static bool fileStamp(const string& path, uint64_t& size, int64_t& mtime) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+    mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+    return true;
+}
+
+/**
+ * @brief Counts the records of a raw or encoded block payload without decoding its text fields.
+ * 
+ * @param payload Payload as stored in the block file.
+ * @return Number of records in the payload.
+ */
+static uint64_t payloadRecordCount(const string& payload) {
+    if (isEncodedPayload(payload)) {
+        vector<int> zips;
+        decodeZipColumn(payload, zips);
+        return zips.size();
+    }
+    return payload.empty() ? 0 : (count(payload.begin(), payload.end(), ',') + 1) / FIELDS_PER_RECORD;
+}
+
+/**
+ * @brief Writes the `<blockFile>.offsets` sidecar locating every block of a finished block file.
+ * 
+ * The sidecar holds the magic, the size and modification time of the block
+ * file, the number of blocks, then one `BlockExtent` per block in file order.
+ * It is only trusted while the block file keeps that size and time.
+ * 
+ * @param blockFile Path to the block file, already closed.
+ * @param extents Position of every block payload.
+ * @return True if successful, false otherwise.
+ */
+static bool writeBlockOffsets(const string& blockFile, const vector<BlockExtent>& extents) {
+    uint64_t size, count = extents.size();
+    int64_t mtime;
+    if (!fileStamp(blockFile, size, mtime)) {
+        return false;
+    }
+    ofstream sidecar(blockFile + ".offsets", ios::binary | ios::trunc);
+    sidecar.write(OFFSETS_MAGIC, sizeof(OFFSETS_MAGIC));
+    sidecar.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    sidecar.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+    sidecar.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    sidecar.write(reinterpret_cast<const char*>(extents.data()), static_cast<streamsize>(count * sizeof(BlockExtent)));
+    if (!sidecar) {
+        cerr << "Error: Could not write " << blockFile << ".offsets" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the `<blockFile>.offsets` sidecar if it still describes the block file.
+ * 
+ * @param blockFile Path to the block file.
+ * @param extents Receives the position of every block payload, in file order.
+ * @return True if the sidecar exists and matches the block file, false otherwise.
+ */
+static bool readBlockOffsets(const string& blockFile, vector<BlockExtent>& extents) {
+    uint64_t size, count;
+    int64_t mtime;
+    if (!fileStamp(blockFile, size, mtime)) {
+        return false;
+    }
+    ifstream sidecar(blockFile + ".offsets", ios::binary);
+    char magic[sizeof(OFFSETS_MAGIC)];
+    uint64_t storedSize;
+    int64_t storedMtime;
+    if (!sidecar.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), OFFSETS_MAGIC)
+        || !sidecar.read(reinterpret_cast<char*>(&storedSize), sizeof(storedSize))
+        || !sidecar.read(reinterpret_cast<char*>(&storedMtime), sizeof(storedMtime))
+        || !sidecar.read(reinterpret_cast<char*>(&count), sizeof(count))
+        || storedSize != size || storedMtime != mtime || count > size) {
+        return false;
+    }
+    extents.resize(count);
+    return static_cast<bool>(sidecar.read(reinterpret_cast<char*>(extents.data()),
+                                          static_cast<streamsize>(count * sizeof(BlockExtent))));
+}
+
+/**
+ * @brief Reads the payload of a block that is still on disk.
+ * 
+ * The whole line is read, so the RBN and checksum come from the file itself.
+ * 
+ * @param block Block opened by `openBlockFile` and not yet read.
+ * @param payload Receives the raw or encoded payload.
+ * @param verify Whether to check the payload against its checksum.
+ * @return True if successful, false if the line cannot be read, is malformed or fails its checksum.
+ */
+static bool readBlockPayload(const Block& block, string& payload, bool verify) {
+    payload.resize(block.fileLength);
+    size_t done = 0;
+    while (done < block.fileLength) {
+        ssize_t count = pread(lazyBlockFd, &payload[done], block.fileLength - done, block.fileOffset + done);
+        if (count <= 0) {
+            cerr << "Error: Could not read block " << block.RBN << " from the block file" << endl;
+            return false;
+        }
+        done += static_cast<size_t>(count);
+    }
+
+    int RBN;
+    uint32_t checksum = 0;
+    bool hasChecksum;
+    size_t payloadStart = parseBlockLine(payload, RBN, checksum, hasChecksum);
+    if (payloadStart == string::npos || RBN != block.RBN) {
+        cerr << "Error: Block " << block.RBN << " is not where the offsets file puts it" << endl;
+        return false;
+    }
+    if (verify && hasChecksum
+        && !blockChecksumMatches(RBN, payload.data() + payloadStart, payload.size() - payloadStart, checksum)) {
+        return false;
+    }
+    payload.erase(0, payloadStart);
+    return true;
+}
+
+/**
+ * @brief Keeps the next blocks of a scan requested from `blockReadAhead`.
+ * 
+ * The scan calls `visit` as it reaches each block. The blocks that follow it,
+ * up to the read-ahead depth, are then read in the background while the scan
+ * works on the current one. The window is refilled once half of it has been
+ * visited, with blocks that are adjacent in the file merged into one request,
+ * so the scan touches the read-ahead thread once per batch rather than once
+ * per block. Only blocks still on disk are requested; when no file is open
+ * lazily this does nothing.
+ */
+class ScanReadAhead {
+public:
+    /**
+     * @param next Gives the block the scan visits after a block, or -1 at the end.
+     */
+    explicit ScanReadAhead(function<int(int)> next) : next(move(next)) {}
+
+    /**
+     * @brief Drops the reads past the point where the scan stopped.
+     */
+    ~ScanReadAhead() {
+        if (blockReadAhead) {
+            blockReadAhead->cancel();
+        }
+    }
+
+    /**
+     * @brief Tells the read-ahead that the scan reached a block.
+     * 
+     * @param RBN Block the scan is about to read.
+     */
+    void visit(int RBN) {
+        if (!blockReadAhead || !blockReadAhead->active()) {
+            return;
+        }
+        if (!ahead.empty() && ahead.front() == RBN) {
+            ahead.pop_front();
+        } else {
+            ahead.clear();  // The scan left the predicted path; predict again from here
+            frontier = RBN;
+        }
+        if (ahead.size() > readAheadDepth / 2 || frontier == -1) {
+            return;
+        }
+
+        long long spanStart = -1;  ///< Blocks adjacent in the file, not yet requested
+        long long spanEnd = -1;
+        while (ahead.size() < readAheadDepth) {
+            int nextRBN = next(frontier);
+            auto found = blocks.find(nextRBN);
+            if (found == blocks.end()) {
+                frontier = -1;
+                break;
+            }
+            const Block& block = found->second;
+            if (block.fileOffset >= 0) {
+                long long end = block.fileOffset + static_cast<long long>(block.fileLength) + 1;  // With its newline
+                if (block.fileOffset != spanEnd) {
+                    if (spanStart != -1) {
+                        blockReadAhead->request(spanStart, static_cast<size_t>(spanEnd - spanStart));
+                    }
+                    spanStart = block.fileOffset;
+                }
+                spanEnd = end;
+            }
+            ahead.push_back(nextRBN);
+            frontier = nextRBN;
+        }
+        if (spanStart != -1) {
+            blockReadAhead->request(spanStart, static_cast<size_t>(spanEnd - spanStart));
+        }
+    }
+
+    /**
+     * @brief Gives the successor of a block on the active list.
+     * 
+     * @param RBN Current block.
+     * @return The successor, or -1 at the end of the list.
+     */
+    static int successor(int RBN) {
+        auto found = blocks.find(RBN);
+        return found == blocks.end() ? -1 : found->second.successorRBN;
+    }
+
+    /**
+     * @brief Gives the block after a block in physical (RBN) order.
+     * 
+     * @param RBN Current block.
+     * @return The next block, or -1 after the last one.
+     */
+    static int physicalSuccessor(int RBN) {
+        auto found = blocks.upper_bound(RBN);
+        return found == blocks.end() ? -1 : found->first;
+    }
+
+private:
+    function<int(int)> next;  ///< Order of the scan
+    deque<int> ahead;         ///< Blocks requested ahead of the scan, in visiting order
+    int frontier = -1;        ///< Last block requested
+};
+
+/**
+ * @brief Reads the header of an existing block file.
+ * 
+ * @param blockFile Path to the block file.
+ * @param header Receives the header.
+ * @return True if successful, false if the file does not exist or has no valid header.
+ */
+static bool readFileHeader(const string& blockFile, HeaderRecord& header) {
+    return access(blockFile.c_str(), F_OK) == 0 && header.readHeader(blockFile);
+}
+
+/**
+ * @brief Gets the name of a layout as stored in the header record.
+ * 
+ * @param layout Layout to name.
+ * @return "zip" or "hilbert".
+ */
+string layoutName(BlockLayout layout) {
+    return layout == BlockLayout::Hilbert ? "hilbert" : "zip";
+}
+
+/**
+ * @brief Parses a layout name stored in the header record.
+ * 
+ * @param name Layout name; unknown names map to `BlockLayout::Zip`.
+ * @return The layout.
+ */
+BlockLayout layoutFromName(const string& name) {
+    return name == "hilbert" ? BlockLayout::Hilbert : BlockLayout::Zip;
+}
+
+/**
+ * @brief Reads the layout recorded in the header of a block file.
+ * 
+ * @param blockFile Path to the block file.
+ * @return The layout of the file, or `BlockLayout::Zip` if the header cannot be read.
+ */
+BlockLayout blockFileLayout(const string& blockFile) {
+    HeaderRecord header;
+    return readFileHeader(blockFile, header) ? layoutFromName(header.getBlockLayout()) : BlockLayout::Zip;
+}
+
+/**
+ * @brief Reads the numeric zip code at the start of a CSV line.
+ * 
+ * @param line CSV line of a record.
+ * @return The zip code, or 0 if the line does not start with a number.
+ */
+static long lineZip(const string& line) {
+    return strtol(line.c_str(), nullptr, 10);
+}
+
+/**
+ * @brief Orders CSV lines along the Hilbert curve of their latitude and longitude.
+ * 
+ * Lines whose coordinates cannot be read sort as (0, 0). Ties keep zip order.
+ * 
+ * @param lines CSV lines of the records, reordered in place.
+ */
+static void sortByHilbertIndex(vector<string>& lines) {
+    vector<pair<uint64_t, size_t>> order;
+    order.reserve(lines.size());
+    for (size_t i = 0; i < lines.size(); i++) {
+        vector<string> fields = splitRecords(lines[i]);
+        double latitude = 0, longitude = 0;
+        if (fields.size() >= FIELDS_PER_RECORD) {
+            latitude = strtod(fields[4].c_str(), nullptr);
+            longitude = strtod(fields[5].c_str(), nullptr);
+        }
+        order.emplace_back(hilbertIndex(latitude, longitude), i);
+    }
+    stable_sort(order.begin(), order.end(),
+                [](const pair<uint64_t, size_t>& a, const pair<uint64_t, size_t>& b) { return a.first < b.first; });
+
+    vector<string> sorted;
+    sorted.reserve(lines.size());
+    for (const auto& entry : order) {
+        sorted.push_back(move(lines[entry.second]));
+    }
+    lines = move(sorted);
+}
+
+/**
+ * @brief Joins the records of a block into the payload stored in the block file.
+ * 
+ * @param records Records stored in the block.
+ * @return Comma separated records.
+ */
+string joinRecords(const vector<string>& records) {
+    string payload;
+    size_t length = records.size();
+    for (const string& record : records) length += record.size();
+    payload.reserve(length);
+    for (size_t i = 0; i < records.size(); i++) {
+        payload += records[i];
+        if (i < records.size() - 1) payload += ",";
+    }
+    return payload;
+}
+
+/**
+ * @brief Splits a block payload back into its records.
+ * 
+ * @param payload Comma separated records.
+ * @return Records stored in the block.
+ */
+vector<string> splitRecords(const string& payload) {
+    vector<string> records;
+    records.reserve(count(payload.begin(), payload.end(), ',') + 1);
+    size_t start = 0;
+    while (start < payload.size()) {
+        size_t comma = payload.find(',', start);
+        if (comma == string::npos) comma = payload.size();
+        records.emplace_back(payload, start, comma - start);
+        start = comma + 1;
+    }
+    return records;
+}
+
+/**
+ * @brief Installs a block image, appending unknown blocks to the end of the active list.
+ * 
+ * @param table Block table to update.
+ * @param headRBN Head of the active list of the table; set if the table was empty.
+ * @param RBN Relative Block Number of the block.
+ * @param records Records stored in the block.
+ */
+static void applyBlockImage(map<int, Block>& table, int& headRBN, int RBN, vector<string> records) {
+    auto it = table.find(RBN);
+    if (it != table.end()) {
+        setBlockRecords(it->second, move(records));
+        return;
+    }
+
+    int tailRBN = headRBN;
+    while (tailRBN != -1 && table[tailRBN].successorRBN != -1) {
+        tailRBN = table[tailRBN].successorRBN;
+    }
+    Block& block = table[RBN];
+    block = Block{RBN, false, {}, tailRBN, -1};
+    setBlockRecords(block, move(records));
+    if (tailRBN != -1) {
+        table[tailRBN].successorRBN = RBN;
+    } else {
+        headRBN = RBN;
+    }
+}
+
+/**
+ * @brief Replays the redo log of a block file into a block table.
+ * 
+ * @param blockFile Path to the block file the log belongs to.
+ * @param table Block table loaded from the block file.
+ * @param headRBN Head of the active list of the table.
+ * @return Number of log entries replayed.
+ */
+size_t replayBlockLog(const string& blockFile, map<int, Block>& table, int& headRBN) {
+    return WriteAheadLog::replay(blockFile + ".log", [&](int RBN, const string& payload) {
+        applyBlockImage(table, headRBN, RBN, splitRecords(payload));
+    });
+}
+
 /**
  * @brief Creates a block file from an input CSV file.
  * 
- * This function reads an input CSV file, divides its data into fixed-size blocks, 
- * and writes those blocks into a new output file.
+ * This function reads an input CSV file, divides its data into fixed-size blocks, 
+ * and writes those blocks into a new output file. The redo log of the output file 
+ * is emptied, since its block images belong to the file being replaced.
+ * 
+ * @param inputFile Path to the input CSV file.
+ * @param outputFile Path to the output block file.
+ * @param BLOCK_SIZE Maximum size of each block in bytes.
+ * @param codec Codec used to compress block payloads.
+ * @param layout Order records are packed in: zip code order, or Hilbert order so
+ *               that each block covers a small area.
+ * @return True if the file was successfully created, false otherwise.
+ */
+bool createBlockFile(const std::string& inputFile, const std::string& outputFile, size_t BLOCK_SIZE,
+                     BlockCodec codec, BlockLayout layout) {
+    ifstream inFile(inputFile);
+    ofstream outFile(outputFile);
+    if (!inFile.is_open() || !outFile.is_open()) {
+        cerr << "Error: Could not open input or output file: " << inputFile << " | " << outputFile << endl;
+        return false;
+    }
+
+    // The redo log and offsets of the file being replaced would be applied to this one
+    remove((outputFile + ".offsets").c_str());
+    if (blockLog && blockLogFile == outputFile) {
+        blockLog->truncate();
+        blockFileStale = false;
+    } else {
+        remove((outputFile + ".log").c_str());
+    }
+
+    HeaderRecord header = makeBlockHeader();
+    header.setBlockCodec(codecName(codec));
+    header.setBlockLayout(layoutName(layout));
+    FileFingerprint source;
+    if (fingerprintFile(inputFile, source)) {
+        header.setSource(inputFile, source);
+    }
+
+    // First write the header
+    if (!header.writeHeader(outFile)) {
+        std::cerr << "Failed to write header to output file" << std::endl;
+        return false;
+    }
+
+    // Block size is measured on the raw records; encoded blocks simply end up smaller.
+    // Records inside a block are kept in zip order whatever the layout, so in-block
+    // lookups can binary search the key column.
+    auto blockPayload = [codec, layout](vector<string> lines) {
+        if (layout != BlockLayout::Zip) {
+            stable_sort(lines.begin(), lines.end(),
+                        [](const string& a, const string& b) { return lineZip(a) < lineZip(b); });
+        }
+        string payload = joinRecords(lines);
+        return codec == BlockCodec::None ? payload : encodeBlockPayload(splitRecords(payload), codec);
+    };
+
+    vector<string> lines;                 ///< Records in the order they are packed
+    string line;
+    getline(inFile, line); // Skip header
+    while (getline(inFile, line)) {
+        lines.push_back(line);
+    }
+    if (layout == BlockLayout::Hilbert) {
+        sortByHilbertIndex(lines);
+    }
+
+    size_t blockNumber = 1;               ///< Current block number being written
+    size_t currentBlockSize = 0;          ///< Current size of the block in bytes
+    vector<string> blockRecords;          ///< Records for the current block
+    vector<BlockExtent> extents;          ///< Where each block landed, for the offsets sidecar
+
+    for (const string& record : lines) {
+        size_t lineSize = record.size() + 1; // Include newline character
+        if (currentBlockSize + lineSize > BLOCK_SIZE) {
+            // Write the current block to the output file
+            writeBlockLine(outFile, blockNumber, blockPayload(blockRecords), &extents);
+
+            blockRecords.clear();
+            currentBlockSize = 0;
+            blockNumber++;
+        }
+
+        blockRecords.push_back(record);
+        currentBlockSize += lineSize;
+    }
+
+    // Write the last block if there are remaining records
+    if (!blockRecords.empty()) {
+        writeBlockLine(outFile, blockNumber, blockPayload(blockRecords), &extents);
+    }
+
+    // The header has a fixed size, so it is written again now that the counts are known
+    header.setRecordCount(lines.size());
+    header.setBlockCount(extents.size());
+    header.setActiveListRBN(extents.empty() ? -1 : extents.front().RBN);
+    outFile.seekp(0);
+    header.writeHeader(outFile);
+
+    inFile.close();
+    outFile.close();
+    if (!outFile) {
+        cerr << "Error: Could not write block file: " << outputFile << endl;
+        return false;
+    }
+    writeBlockOffsets(outputFile, extents);
+
+    return true;
+}
+
+/**
+ * @brief Parses a block file into a block table.
+ * 
+ * This function reads a block file, skips its header record, and splits its content 
+ * into blocks. Blocks are chained into the active list in the order they appear in 
+ * the file. Encoded payloads are kept as they are until `materializeBlock` decodes them.
+ * A block that fails its checksum is kept in the table without records and marked 
+ * corrupt, so `materializeBlock` and `getBlockByRBN` refuse it while the other 
+ * blocks stay readable.
+ * 
+ * @param blockFile Path to the block file to parse.
+ * @param table Block table receiving the parsed blocks.
+ * @return RBN of the first block in the file, or -1 if no block was read.
+ */
+int loadBlockFile(const string& blockFile, map<int, Block>& table) {
+    ifstream inFile(blockFile);
+    if (!inFile.is_open()) {
+        cerr << "Error: Could not open block file: " << blockFile << endl;
+        return -1;
+    }
+
+    HeaderRecord header;
+    if (!header.readHeader(inFile)) {
+        cerr << "Error: Could not read header of block file: " << blockFile << endl;
+        return -1;
+    }
+
+    string line;
+    int headRBN = -1;      ///< First block of the active list
+    int previousRBN = -1;  ///< Last block placed on the active list
+    while (getline(inFile, line)) {
+        int RBN;                 ///< Extracted RBN of the block
+        uint32_t checksum = 0;   ///< Checksum of the payload, if the line has one
+        bool hasChecksum;
+        size_t payloadStart = parseBlockLine(line, RBN, checksum, hasChecksum);
+        if (payloadStart == string::npos) continue;
+        bool corrupt = hasChecksum && shouldVerifyBlock()
+            && !blockChecksumMatches(RBN, line.data() + payloadStart, line.size() - payloadStart, checksum);
+        line.erase(0, payloadStart);  // The payload stays in the line instead of being copied out
+        string& recordsPart = line;
+
+        Block& block = table[RBN];
+        block.RBN = RBN;
+        block.isAvailable = false;
+        if (corrupt) {
+            // Nothing in the payload can be trusted, not even its zip codes
+            setBlockRecords(block, {});
+            block.corrupt = true;
+        } else if (isEncodedPayload(recordsPart)) {
+            // Only the zip column is decoded; the payload waits for materializeBlock
+            vector<int> zips;
+            decodeZipColumn(recordsPart, zips);
+            block.keys.build(zips);
+            block.records.clear();
+            block.encoded = move(recordsPart);
+        } else {
+            setBlockRecords(block, splitRecords(recordsPart));
+        }
+        block.predecessorRBN = previousRBN;
+        block.successorRBN = -1;
+        if (previousRBN != -1) {
+            table[previousRBN].successorRBN = RBN;
+        } else {
+            headRBN = RBN;
+        }
+        previousRBN = RBN;
+    }
+
+    inFile.close();
+    return headRBN;
+}
+
+/**
+ * @brief Empties the global map of blocks and resets both list heads.
+ * 
+ * The state extremes are rebuilt from the next blocks loaded.
+ */
+void clearBlocks() {
+    blockReadAhead.reset();
+    if (lazyBlockFd != -1) {
+        ::close(lazyBlockFd);
+        lazyBlockFd = -1;
+    }
+    blocks.clear();
+    listHeadRBN = -1;
+    availHeadRBN = -1;
+    stateExtremes.clear();
+    stateExtremesBuilt = false;
+}
+
+/**
+ * @brief Opens a block file without reading its blocks.
+ * 
+ * Each block gets its position from the `<blockFile>.offsets` sidecar and is
+ * chained in file order, as `parseBlockFile` would. Payloads stay on disk
+ * until `materializeBlock`, so opening costs one read of the sidecar however
+ * large the file is. A missing or outdated sidecar falls back to parsing.
+ * 
+ * @param blockFile Path to the block file to open.
+ * @return True if successful, false otherwise.
+ */
+bool openBlockFile(const string& blockFile) {
+    vector<BlockExtent> extents;
+    if (!readBlockOffsets(blockFile, extents)) {
+        parseBlockFile(blockFile);
+        return listHeadRBN != -1;
+    }
+    int fd = ::open(blockFile.c_str(), O_RDONLY);
+    if (fd == -1) {
+        cerr << "Error: Could not open block file: " << blockFile << endl;
+        return false;
+    }
+    HeaderRecord header;
+    if (!header.readHeader(fd) || header.getBlockCount() != extents.size()) {
+        ::close(fd);
+        cerr << "Error: Header of block file does not match its offsets: " << blockFile << endl;
+        return false;
+    }
+    clearBlocks();
+    lazyBlockFd = fd;
+    if (readAheadDepth > 0) {
+        blockReadAhead = make_unique<ReadAhead>(fd);
+    }
+
+    int previousRBN = -1;
+    for (const BlockExtent& extent : extents) {
+        Block& block = blocks[extent.RBN];
+        block.RBN = extent.RBN;
+        block.isAvailable = false;
+        block.fileOffset = extent.offset;
+        block.fileLength = extent.length;
+        block.predecessorRBN = previousRBN;
+        block.successorRBN = -1;
+        if (previousRBN != -1) {
+            blocks[previousRBN].successorRBN = extent.RBN;
+        } else {
+            listHeadRBN = extent.RBN;
+        }
+        previousRBN = extent.RBN;
+    }
+    return listHeadRBN != -1;
+}
+
+/**
+ * @brief Checks whether a block file was built from the current version of a CSV file.
+ * 
+ * @param blockFile Path to the block file.
+ * @param sourceFile Path to the CSV file.
+ * @return True if the fingerprint in the block file header matches the CSV file, false otherwise.
+ */
+bool blockFileMatchesSource(const string& blockFile, const string& sourceFile) {
+    HeaderRecord header;
+    FileFingerprint current;
+    return readFileHeader(blockFile, header) && !header.getSourceFile().empty()
+        && fingerprintFile(sourceFile, current) && current == header.getSourceFingerprint();
+}
+
+/**
+ * @brief Parses a block file and populates the global map of blocks.
+ * 
+ * This function reads a block file, splits its content into blocks, 
+ * and populates the `blocks` map with their respective details.
  * 
- * @param inputFile Path to the input CSV file.
- * @param outputFile Path to the output block file.
- * @param BLOCK_SIZE Maximum size of each block in bytes.
- * @return True if the file was successfully created, false otherwise.
+ * @param blockFile Path to the block file to parse.
  */
-bool createBlockFile(const std::string& inputFile, const std::string& outputFile, size_t BLOCK_SIZE) {
-    ifstream inFile(inputFile);
-    ofstream outFile(outputFile);
-    if (!inFile.is_open() || !outFile.is_open()) {
-        cerr << "Error: Could not open input or output file: " << inputFile << " | " << outputFile << endl;
-        return false;
+void parseBlockFile(const string& blockFile) {
+    int headRBN = loadBlockFile(blockFile, blocks);
+    if (listHeadRBN == -1) {
+        listHeadRBN = headRBN;
     }
+}
 
-    HeaderRecord header;
-    
-    // Set basic header information
-    header.setFileStructureType("blocked_sequence_set");
-    header.setVersion("1.0");
-    header.setBlockSize(512);  // Default block size
-    header.setMinBlockCapacity(0.5);  // 50% minimum capacity
-    header.setIndexFileName("headerTest.idx");
-    header.setIndexSchema("key:string,rbn:int");
-    
-    // Set primary key field (zip_code is field 0)
-    header.setPrimaryKeyField(0);
-
-    // First write the header
-    if (!header.writeHeader(outFile)) {
-        std::cerr << "Failed to write header to output file" << std::endl;
+/**
+ * @brief Reads the payload of a block from disk and decodes it into its records, if necessary.
+ * 
+ * @param block Block loaded by `loadBlockFile` or `parseBlockFile`.
+ * @return True if the block records are available, false if the payload is malformed or fails its checksum.
+ */
+bool materializeBlock(Block& block) {
+    if (block.corrupt) {
         return false;
     }
+    if (block.fileOffset >= 0) {
+        string payload;
+        if (!readBlockPayload(block, payload, shouldVerifyBlock())) {
+            return false;
+        }
+        block.fileOffset = -1;
+        if (!isEncodedPayload(payload)) {
+            setBlockRecords(block, splitRecords(payload));
+            return !block.records.empty();
+        }
+        block.encoded = move(payload);
+    }
+    if (block.encoded.empty()) {
+        return true;
+    }
+    METRICS_TIME(Histogram::BlockDecode);
+    METRICS_COUNT(Counter::BlockDecodes, 1);
+    setBlockRecords(block, decodeBlockPayload(block.encoded));
+    return !block.records.empty();
+}
 
-    size_t blockNumber = 1;               ///< Current block number being written
-    size_t currentBlockSize = 0;          ///< Current size of the block in bytes
-    vector<string> blockRecords;          ///< Records for the current block
+/**
+ * @brief Replaces the records of a block and rebuilds its key column.
+ * 
+ * @param block Block to update.
+ * @param records New records of the block.
+ */
+void setBlockRecords(Block& block, vector<string> records) {
+    block.records = move(records);
+    block.encoded.clear();
+    block.fileOffset = -1;
+    block.corrupt = false;
 
-    string line;
-    getline(inFile, line); // Skip header
-    while (getline(inFile, line)) {
-        size_t lineSize = line.size() + 1; // Include newline character
-        if (currentBlockSize + lineSize > BLOCK_SIZE) {
-            // Write the current block to the output file
-            outFile << blockNumber << ":";
-            for (size_t i = 0; i < blockRecords.size(); i++) {
-                outFile << blockRecords[i];
-                if (i < blockRecords.size() - 1) outFile << ",";
-            }
-            outFile << "\n";
+    vector<int> zips;
+    zips.reserve(block.records.size() / FIELDS_PER_RECORD);
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= block.records.size(); i += FIELDS_PER_RECORD) {
+        char* end = nullptr;
+        long zip = strtol(block.records[i].c_str(), &end, 10);
+        if (block.records[i].empty() || *end != '\0') {
+            block.keys.build({});  // Non-numeric keys are searched by string comparison
+            return;
+        }
+        zips.push_back(static_cast<int>(zip));
+    }
+    block.keys.build(zips);
+}
 
-            blockRecords.clear();
-            currentBlockSize = 0;
-            blockNumber++;
+/**
+ * @brief Finds the record with a given zip code inside a block.
+ * 
+ * @param block Block to search.
+ * @param zip Zip code to look for.
+ * @param fields Receives the fields of the matching record.
+ * @return True if the record was found, false otherwise.
+ */
+bool findRecordInBlock(const Block& block, const string& zip, vector<string>& fields) {
+    char* end = nullptr;
+    long key = strtol(zip.c_str(), &end, 10);
+    if (!zip.empty() && *end == '\0' && block.keys.size() * FIELDS_PER_RECORD == block.records.size()
+        && block.keys.size() > 0) {
+        int ordinal = block.keys.find(static_cast<int>(key));
+        if (ordinal < 0) {
+            return false;
+        }
+        auto first = block.records.begin() + static_cast<size_t>(ordinal) * FIELDS_PER_RECORD;
+        fields.assign(first, first + FIELDS_PER_RECORD);
+        return true;
+    }
+
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= block.records.size(); i += FIELDS_PER_RECORD) {
+        if (block.records[i] == zip) {
+            fields.assign(block.records.begin() + i, block.records.begin() + i + FIELDS_PER_RECORD);
+            return true;
         }
+    }
+    return false;
+}
 
-        blockRecords.push_back(line);
-        currentBlockSize += lineSize;
+/**
+ * @brief Writes the global block map back to a block file.
+ * 
+ * The file is written to a temporary name, synced, and renamed over the 
+ * original so that a crash never leaves a half written block file behind.
+ * Blocks are written in logical order; any block not on the active list 
+ * follows in physical order. Available blocks are not written, so the header 
+ * records no available list. Blocks that were never read from disk are copied 
+ * after their checksum is checked, and a corrupted one stops the write; the 
+ * others are encoded with the codec of the existing file. 
+ * The written header is never stale.
+ * 
+ * @param outputFile Path to the block file to write.
+ * @return True if successful, false otherwise.
+ */
+bool writeBlockFile(const string& outputFile) {
+    return writeBlockFile(outputFile, blocks, listHeadRBN);
+}
+
+/**
+ * @brief Writes a block table back to a block file.
+ * 
+ * Works like the global `writeBlockFile`, for tables owned by a `SequenceSet` 
+ * or a `SnapshotSet`.
+ * 
+ * @param outputFile Path to the block file to write.
+ * @param table Blocks to write, by RBN.
+ * @param headRBN Head of the active list of the table.
+ * @return True if successful, false otherwise.
+ */
+bool writeBlockFile(const string& outputFile, const map<int, Block>& table, int headRBN) {
+    string tempFile = outputFile + ".tmp";
+    ofstream outFile(tempFile);
+    if (!outFile.is_open()) {
+        cerr << "Error: Could not open output file: " << tempFile << endl;
+        return false;
     }
 
-    // Write the last block if there are remaining records
-    if (!blockRecords.empty()) {
-        outFile << blockNumber << ":";
-        for (size_t i = 0; i < blockRecords.size(); i++) {
-            outFile << blockRecords[i];
-            if (i < blockRecords.size() - 1) outFile << ",";
+    // Keep the codec and layout of the file being replaced
+    HeaderRecord existing;
+    readFileHeader(outputFile, existing);
+    BlockCodec codec = codecFromName(existing.getBlockCodec());
+    HeaderRecord header = makeBlockHeader();
+    header.setBlockCodec(codecName(codec));
+    header.setBlockLayout(existing.getBlockLayout());
+    header.setSource(existing.getSourceFile(), existing.getSourceFingerprint());
+    header.setStaleFlag(false);
+    if (!header.writeHeader(outFile)) {
+        cerr << "Failed to write header to output file" << endl;
+        return false;
+    }
+
+    map<int, bool> written;
+    vector<BlockExtent> extents;
+    uint64_t recordCount = 0;
+    bool intact = true;  ///< False once a block copied from the old file fails its checksum
+    auto writeBlock = [&](int RBN, const Block& block) {
+        string payload;
+        if (block.corrupt) {
+            intact = false;  // Its records were never loaded, so writing it would drop them
+            return;
+        }
+        if (block.fileOffset >= 0) {
+            // Never read, so copied as it is on disk; always checked, or a new checksum would hide the damage
+            intact = intact && readBlockPayload(block, payload, true);
+        } else {
+            payload = block.encoded.empty() ? encodeBlockPayload(block.records, codec) : block.encoded;
+        }
+        recordCount += payloadRecordCount(payload);
+        writeBlockLine(outFile, RBN, payload, &extents);
+    };
+    for (auto it = table.find(headRBN); it != table.end() && !written[it->first]; it = table.find(it->second.successorRBN)) {
+        writeBlock(it->first, it->second);
+        written[it->first] = true;
+    }
+    for (const auto& [RBN, block] : table) {
+        if (!written[RBN] && !block.isAvailable) {
+            writeBlock(RBN, block);
         }
-        outFile << "\n";
+    }
+    if (!intact) {
+        outFile.close();
+        remove(tempFile.c_str());
+        cerr << "Error: Not replacing " << outputFile << " since it has corrupted blocks" << endl;
+        return false;
     }
 
-    inFile.close();
+    // The header has a fixed size, so it is written again now that the counts are known
+    header.setRecordCount(recordCount);
+    header.setBlockCount(extents.size());
+    header.setActiveListRBN(headRBN);
+    header.setAvailListRBN(-1);  // Available blocks are left out of the file
+    outFile.seekp(0);
+    header.writeHeader(outFile);
+
     outFile.close();
+    if (!outFile) {
+        cerr << "Error: Could not write block file: " << tempFile << endl;
+        return false;
+    }
 
+    int fd = ::open(tempFile.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+    if (rename(tempFile.c_str(), outputFile.c_str()) != 0) {
+        cerr << "Error: Could not replace block file: " << outputFile << endl;
+        return false;
+    }
+    writeBlockOffsets(outputFile, extents);
     return true;
 }
 
 /**
- * @brief Parses a block file and populates the global map of blocks.
+ * @brief Opens the redo log protecting a block file.
  * 
- * This function reads a block file, splits its content into blocks, 
- * and populates the `blocks` map with their respective details.
+ * After this call every `updateBlock` is written to `<blockFile>.log` before it 
+ * is applied in memory. Every `fsyncBatchSize` updates share one fsync.
  * 
- * @param blockFile Path to the block file to parse.
+ * @param blockFile Path to the block file the log belongs to.
+ * @param fsyncBatchSize Number of logged updates per fsync.
+ * @return True if successful, false otherwise.
  */
-void parseBlockFile(const string& blockFile) {
-    ifstream inFile(blockFile);
-    if (!inFile.is_open()) {
-        cerr << "Error: Could not open block file: " << blockFile << endl;
-        return;
-    }
+bool openBlockLog(const string& blockFile, size_t fsyncBatchSize) {
+    blockLog = make_unique<WriteAheadLog>(blockFile + ".log", fsyncBatchSize);
+    blockLogFile = blockFile;
+    blockFileStale = false;
+    return blockLog->isOpen();
+}
 
-    string line;
-    while (getline(inFile, line)) {
-        size_t colonPos = line.find(':');
-        int RBN = stoi(line.substr(0, colonPos));  ///< Extracted RBN of the block
-        string recordsPart = line.substr(colonPos + 1);
+/**
+ * @brief Forces all logged block updates to stable storage.
+ * 
+ * @return True if successful or no log is open, false otherwise.
+ */
+bool flushBlockLog() {
+    return !blockLog || blockLog->sync();
+}
 
-        vector<string> records;                   ///< Records in the block
-        stringstream recordStream(recordsPart);
-        string record;
-        while (getline(recordStream, record, ',')) {
-            records.push_back(record);
+/**
+ * @brief Replaces the records of a block, logging the new image first.
+ * 
+ * The first logged update after a checkpoint marks the block file header 
+ * stale, since the file no longer reflects every committed block.
+ * 
+ * @param RBN Relative Block Number of the block to update.
+ * @param records New records of the block.
+ * @return True if successful, false otherwise.
+ */
+bool updateBlock(int RBN, const vector<string>& records) {
+    METRICS_COUNT(Counter::BlockUpdates, 1);
+    if (blockLog) {
+        if (!blockFileStale) {
+            HeaderRecord header;
+            header.setStaleFlag(true);
+            blockFileStale = header.writeStaleFlag(blockLogFile);
+        }
+        if (blockLog->append(RBN, joinRecords(records)) == 0) {
+            cerr << "Error: Could not log update of block " << RBN << endl;
+            return false;
         }
+    }
 
-        // Create a block using the parsed data
-        createBlock(RBN, false, records, -1, -1);
+    if (stateExtremesBuilt) {
+        auto it = blocks.find(RBN);
+        if (it != blocks.end() && !it->second.isAvailable) {
+            materializeBlock(it->second);
+            stateExtremes.removeRecords(it->second.records);
+        }
+        stateExtremes.addRecords(records);
+    }
+    // The index files are only rebuilt at startup, so search finds new zip codes through these
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+        char* end = nullptr;
+        long zip = strtol(records[i].c_str(), &end, 10);
+        if (!records[i].empty() && *end == '\0') {
+            updatedZips[static_cast<int>(zip)] = RBN;
+            if (searchFilter.isReady()) {
+                searchFilter.add(static_cast<int>(zip));
+            }
+        }
     }
+    applyBlockImage(blocks, listHeadRBN, RBN, records);
+    return true;
+}
 
-    inFile.close();
+/**
+ * @brief Writes the in-memory blocks to the block file and empties the redo log.
+ * 
+ * @param blockFile Path to the block file.
+ * @return True if successful, false otherwise.
+ */
+bool checkpointBlockFile(const string& blockFile) {
+    if (!flushBlockLog() || !writeBlockFile(blockFile)) {
+        return false;
+    }
+
+    if (blockLog && blockLogFile == blockFile) {
+        blockFileStale = false;
+        return blockLog->truncate();
+    }
+    ofstream logFile(blockFile + ".log", ios::trunc);
+    return logFile.is_open();
+}
+
+/**
+ * @brief Replays the redo log of a block file over the parsed blocks.
+ * 
+ * Must be called after `parseBlockFile`. If the log held any entries or the 
+ * header was left stale, the block file is checkpointed, which clears the 
+ * stale flag and empties the log.
+ * 
+ * @param blockFile Path to the block file.
+ * @return Number of log entries replayed, or -1 if the checkpoint failed.
+ */
+int recoverBlockFile(const string& blockFile) {
+    HeaderRecord header;
+    if (!header.readHeader(blockFile)) {
+        return -1;
+    }
+
+    size_t replayed = replayBlockLog(blockFile, blocks, listHeadRBN);
+
+    if (replayed > 0 || header.getStaleFlag()) {
+        if (!checkpointBlockFile(blockFile)) {
+            return -1;
+        }
+    }
+    return static_cast<int>(replayed);
 }
 
 /**
@@ -152,7 +1260,10 @@ void parseBlockFile(const string& blockFile) {
  */
 void dumpPhysicalOrder() {
     cout << "Dumping Blocks by Physical Order:\n";                                        
-    for (const auto& [RBN, block] : blocks) {
+    ScanReadAhead readAhead(ScanReadAhead::physicalSuccessor);
+    for (auto& [RBN, block] : blocks) {
+        readAhead.visit(RBN);
+        materializeBlock(block);
         cout << "RBN: " << RBN << " ";
         for (const string& record : block.records) {
             cout << record << " ";
@@ -170,8 +1281,11 @@ void dumpPhysicalOrder() {
 void dumpLogicalOrder() {
     cout << "Dumping Blocks by Logical Order:\n";
     int currentRBN = listHeadRBN;  ///< Start from the logical list head
+    ScanReadAhead readAhead(ScanReadAhead::successor);
     while (currentRBN != -1) {
-        const Block& block = blocks[currentRBN];
+        readAhead.visit(currentRBN);
+        Block& block = blocks[currentRBN];
+        materializeBlock(block);
         cout << "RBN: " << currentRBN << " ";
         for (const string& record : block.records) {
             cout << record << " " ;
@@ -191,97 +1305,52 @@ struct mostStorage {
     double latitude;
     double longitude;
 };
+
+/**
+ * @brief Gets the extreme zip codes of every state over the active blocks.
+ * 
+ * The first call scans the blocks; later calls return the structure kept
+ * current by `updateBlock` and `createBlock`.
+ * 
+ * @return Extreme zip codes of every state.
+ */
+const StateExtremes& currentStateExtremes() {
+    if (!stateExtremesBuilt) {
+        stateExtremes.clear();
+        ScanReadAhead readAhead(ScanReadAhead::physicalSuccessor);
+        for (auto& [RBN, block] : blocks) {
+            readAhead.visit(RBN);
+            if (!block.isAvailable && materializeBlock(block)) {
+                stateExtremes.addRecords(block.records);
+            }
+        }
+        stateExtremesBuilt = true;
+    }
+    return stateExtremes;
+}
+
 /**
  * @brief Finds and lists the extreme points (easternmost, westernmost, 
  *        northernmost, southernmost) for each state
  *
- * This function processes a collection of blocks containing location records,
- * identifying the extreme geographical points for each state based on 
- * longitude and latitude coordinates.
- * 
- * @details The function performs the following steps:
- * - Iterates through all blocks and their records
- * - Extracts state, ZIP code, latitude, and longitude information
- * - Tracks the extreme points for each state
- * - Stores the results in a map of state to extreme locations
- * - Prints out the extreme point ZIP codes for each state
- *
- * @note Assumes records are in a specific order:
- *       - Record 1: ZIP code
- *       - Record 3: State
- *       - Record 5: Latitude
- *       - Record 6: Longitude
+ * The extremes come from `currentStateExtremes`, so only the first report
+ * reads the blocks.
  * 
  * @pre Requires a global `blocks` container with records
  * @post Prints extreme point information for each state
  */
 void listMost() {
-	int currentRBN = listHeadRBN;
-	int recordPart = 0;
-	int testnum = 0;
-	mostStorage current, easternmost, westernmost, northernmost, southernmost;
-	std::map<string, std::vector<mostStorage>> sorted_directions;
-
-
-	for (const auto& [RBN, block] : blocks) {
-		  bool initialized = false;
-	
-			for (const string& record : block.records) {
-					recordPart++;
-					if(recordPart == 1){
-					current.zip_code = record;
-					}
-
-					if(recordPart == 3){
-					current.state = record;
-					}
-			 
-				if(recordPart == 5){
-					current.latitude = std::stod(record);
-				}
-				if(recordPart == 6){
-					current.longitude = std::stod(record);
-					if (!initialized) {
-                    easternmost = current;
-                    westernmost = current;
-                    northernmost = current;
-                    southernmost = current;
-                    initialized = true;
-                }
-				if ( current.longitude < easternmost.longitude ) {
-					easternmost = current;
-				}
-				if ( current.longitude > westernmost.longitude ) {
-					westernmost = current;
-				}
-				if ( current.latitude > northernmost.latitude ) {
-					northernmost = current;
-				}
-				if ( current.latitude < southernmost.latitude ) {
-					southernmost = current;
-				}
-				recordPart=0;
-				sorted_directions[ current.state ] = { easternmost, westernmost, northernmost, southernmost };
-				}
-			
-			
-			
-			
-			 }
-							}
-				 
-            
-						
-		 
-		 
+	const StateExtremes& extremes = currentStateExtremes();
+
 	cout <<"State: "<< "Easternmost: " << "westernmost: "<< "northernnmost: "<< "southernnmost: " <<endl;
-	for (const auto& [state, locations] : sorted_directions) {
-        if (locations.size() == 4) {  // Ensure we have all 4 directional records
-				cout << state << ","
-				<< locations[0].zip_code << ","  // Easternmost
-                 << locations[1].zip_code << ","  // Westernmost
-                 << locations[2].zip_code << ","  // Northernmost 
-                 << locations[3].zip_code << "\n";  // Southernmost
+	for (const string& state : extremes.states()) {
+		StateExtremeReport report;
+		if (extremes.extremes(state, report)) {
+			cout << state << ","
+			     << report.easternmost.zip << ","  // Easternmost
+			     << report.westernmost.zip << ","  // Westernmost
+			     << report.northernmost.zip << ","  // Northernmost
+			     << report.southernmost.zip << "\n";  // Southernmost
 		}
 	}
 }
@@ -337,11 +1406,18 @@ std::vector<std::string> splitZipLine(const std::string& str) {
  * @see Block
  */
 Block* getBlockByRBN(int requestedRBN) {
+    METRICS_TIME(Histogram::BlockRead);
+    METRICS_COUNT(Counter::BlockReads, 1);
     // Check if the block exists in the global blocks map
     auto it = blocks.find(requestedRBN);
     
     if (it != blocks.end()) {
-        // Block found, return a pointer to the block
+        // Block found, decode it on first access and return a pointer to the block
+        if (!materializeBlock(it->second)) {
+            std::cerr << "Block with RBN " << requestedRBN
+                      << (it->second.corrupt ? " failed its checksum and is skipped." : " could not be decoded.") << std::endl;
+            return nullptr;
+        }
         return &(it->second);
     } else {
         // Block not found
@@ -350,14 +1426,144 @@ Block* getBlockByRBN(int requestedRBN) {
     }
 }
 
+/**
+ * @brief Sets when block checksums are checked as blocks are read from disk.
+ * 
+ * @param mode Verify mode; `BlockVerifyMode::Always` by default.
+ * @param sampleInterval In sampled mode, one block read in this many is checked.
+ */
+void setBlockVerifyMode(BlockVerifyMode mode, unsigned sampleInterval) {
+    verifyMode = mode;
+    verifySampleInterval = sampleInterval > 0 ? sampleInterval : 1;
+}
+
+/**
+ * @brief Sets how many blocks scans read ahead along their path.
+ * 
+ * Takes effect at the next `openBlockFile`.
+ * 
+ * @param depth Number of blocks kept requested ahead; 0 reads every block synchronously.
+ */
+void setBlockReadAhead(size_t depth) {
+    readAheadDepth = depth;
+}
+
+/**
+ * @brief Parses a verify mode name given on the command line.
+ * 
+ * @param name "always", "sampled" or "off".
+ * @param mode Receives the mode.
+ * @return True if the name is known, false otherwise.
+ */
+bool blockVerifyModeFromName(const string& name, BlockVerifyMode& mode) {
+    if (name == "always") {
+        mode = BlockVerifyMode::Always;
+    } else if (name == "sampled") {
+        mode = BlockVerifyMode::Sampled;
+    } else if (name == "off") {
+        mode = BlockVerifyMode::Off;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks the blocks whose lines start in one byte range of a block file.
+ * 
+ * @param blockFile Path to the block file.
+ * @param begin First byte of the range; never inside the header.
+ * @param end Byte after the range.
+ * @param report Receives the outcome for the range.
+ */
+static void verifyBlockRange(const string& blockFile, uint64_t begin, uint64_t end, BlockFileReport& report) {
+    ifstream inFile(blockFile, ios::binary);
+    string line;
+    uint64_t position = begin;
+    if (begin > HeaderRecord::HEADER_SIZE) {
+        // The line running into the range belongs to the previous one
+        inFile.seekg(static_cast<streamoff>(begin - 1));
+        getline(inFile, line);
+        position = begin - 1 + line.size() + 1;
+    } else {
+        inFile.seekg(static_cast<streamoff>(begin));
+    }
+    while (position < end && getline(inFile, line)) {
+        position += line.size() + 1;
+        int RBN;
+        uint32_t checksum = 0;
+        bool hasChecksum;
+        size_t payloadStart = parseBlockLine(line, RBN, checksum, hasChecksum);
+        if (payloadStart == string::npos) {
+            report.malformed += !line.empty();
+            continue;
+        }
+        report.blocks++;
+        if (!hasChecksum) {
+            report.unchecked++;
+        } else if (!blockChecksumMatches(RBN, line.data() + payloadStart, line.size() - payloadStart, checksum)) {
+            report.corruptRBNs.push_back(RBN);
+        }
+    }
+}
+
+/**
+ * @brief Checks the header and the checksum of every block of a block file, in parallel.
+ * 
+ * The file is split into one byte range per thread, and each thread checks
+ * the blocks whose lines start in its range, whatever the verify mode.
+ * 
+ * @param blockFile Path to the block file.
+ * @param threadCount Number of threads; 0 uses one per hardware thread.
+ * @param report Receives the outcome.
+ * @return True if the file could be read and its header is valid, false otherwise.
+ */
+bool verifyBlockFile(const string& blockFile, unsigned threadCount, BlockFileReport& report) {
+    report = BlockFileReport();
+    HeaderRecord header;
+    uint64_t size;
+    int64_t mtime;
+    if (!fileStamp(blockFile, size, mtime) || !header.readHeader(blockFile)) {
+        return false;
+    }
+    report.expectedBlocks = header.getBlockCount();
+
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    uint64_t body = size - header.getHeaderSize();
+    threadCount = static_cast<unsigned>(min<uint64_t>(threadCount, max<uint64_t>(1, body / (1 << 20))));
+
+    vector<BlockFileReport> parts(threadCount);
+    vector<thread> workers;
+    for (unsigned i = 0; i < threadCount; i++) {
+        uint64_t begin = header.getHeaderSize() + body * i / threadCount;
+        uint64_t end = header.getHeaderSize() + body * (i + 1) / threadCount;
+        workers.emplace_back(verifyBlockRange, cref(blockFile), begin, end, ref(parts[i]));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    for (const BlockFileReport& part : parts) {
+        report.blocks += part.blocks;
+        report.unchecked += part.unchecked;
+        report.malformed += part.malformed;
+        report.corruptRBNs.insert(report.corruptRBNs.end(), part.corruptRBNs.begin(), part.corruptRBNs.end());
+    }
+    return true;
+}
+
 /**
  * @brief Searches for a specific zip code in the block file and index file
  * 
  * This function performs the following steps:
- * 1. Opens the index file and block file
- * 2. Searches for the given zip code in the index file
- * 3. If found, retrieves the corresponding block
- * 4. Parses the block records to extract and display matching record details
+ * 1. Rejects the zip code at once if the Bloom filter `<indexName>.bloom` rules it out;
+ *    zip codes installed by `updateBlock` since the filter was written are added to it
+ * 2. Opens the index file and block file
+ * 3. Looks the zip code up in the blocks installed by `updateBlock`, then in the index file
+ * 4. If found, retrieves the corresponding block
+ * 5. Parses the block records to extract and display matching record details
  * 
  * @param str The zip code to search for
  * @param indexName The name of the index file containing zip code to RBN mappings
@@ -373,6 +1579,28 @@ Block* getBlockByRBN(int requestedRBN) {
  */
 
 void search(const std::string& str, const std::string& indexName){
+	// The filter is loaded once per index file; a missing filter rules nothing out
+	if (searchFilterIndex != indexName) {
+		searchFilter = BloomFilter();
+		if (searchFilter.load(indexName + ".bloom")) {
+			for (const auto& [zip, RBN] : updatedZips) {
+				searchFilter.add(zip);
+			}
+		}
+		searchFilterIndex = indexName;
+	}
+	METRICS_TIME(Histogram::IndexLookup);
+	METRICS_COUNT(Counter::IndexLookups, 1);
+	char* end = nullptr;
+	long key = strtol(str.c_str(), &end, 10);
+	if (!str.empty() && *end == '\0' && !searchFilter.mightContain(static_cast<int>(key))) {
+		METRICS_COUNT(Counter::BloomRejects, 1);
+		METRICS_COUNT(Counter::IndexMisses, 1);
+		METRICS_RECORD(Histogram::BlocksPerQuery, 0);
+		cout << str << " was not found in the file." << endl;
+		return;
+	}
+
 	mostStorage current;
 	bool notfound = true;
 	std::string correct_line;
@@ -390,14 +1618,30 @@ void search(const std::string& str, const std::string& indexName){
 
 	std::string rbn, zipcode, line;
 	int recordPart = 0;
+	size_t blocksTouched = 0;
 	//int i = 5;
 	getline( file2, line );
 	line = "";
-    while ((file2 >> zipcode >> rbn) && !file2.eof()) {  // reads word by word
+	// A zip code installed by updateBlock is looked up in its block before the index file, which lacks it
+	auto updated = updatedZips.find(static_cast<int>(key));
+	bool checkUpdated = !str.empty() && *end == '\0' && updated != updatedZips.end();
+    while (checkUpdated || ((file2 >> zipcode >> rbn) && !file2.eof())) {  // reads word by word
+      if (checkUpdated) {
+        zipcode = str;
+        rbn = to_string(updated->second);
+        checkUpdated = false;
+      }
       if(zipcode == str){
         int block = std::stoi(rbn);
               cout << "Zipcode:  " << zipcode << " is at "<< block <<endl;
         Block* myBlock = getBlockByRBN(block);
+        blocksTouched++;
+        if (myBlock == nullptr) {
+            // The block failed its checksum; report it instead of a miss and go on with the next query
+            cout << "Zipcode:  " << zipcode << " could not be read, block " << block << " is corrupted." << endl;
+            notfound = false;
+            break;
+        }
         for (const string& record : myBlock->records) {
             recordPart++;
             if(recordPart == 1){
@@ -443,17 +1687,115 @@ void search(const std::string& str, const std::string& indexName){
 			
 			
 		//	break;
+			if (!notfound) {
+				break;  // The index file may list a zip code found in an updated block again
+			}
 			}
 			
 			
 			
 	if(notfound){
+			METRICS_COUNT(Counter::IndexMisses, 1);
 			cout<< str << " was not found in the file."<<endl;
 			}
+			METRICS_RECORD(Histogram::BlocksPerQuery, blocksTouched);
 			file2.close();
 }
 
 
+/**
+ * @brief Latitude/longitude bounding box of one block.
+ */
+struct BlockBounds {
+    int RBN;              ///< Block the bounds belong to
+    double minLatitude;   ///< Southernmost record
+    double minLongitude;  ///< Westernmost record
+    double maxLatitude;   ///< Northernmost record
+    double maxLongitude;  ///< Easternmost record
+};
+
+/**
+ * @brief Visits every record inside a latitude/longitude box.
+ * 
+ * The block bounds written by `Index::processBlockData` are loaded once per index
+ * file. Only the blocks whose bounds overlap the box are read, so with the Hilbert
+ * layout a small box touches a few neighbouring blocks instead of the whole file.
+ * 
+ * @param minLatitude Southern edge of the box in degrees.
+ * @param minLongitude Western edge of the box in degrees.
+ * @param maxLatitude Northern edge of the box in degrees.
+ * @param maxLongitude Eastern edge of the box in degrees.
+ * @param indexName Name of the index file written by `Index::processBlockData`.
+ * @param visit Callback receiving the fields of each record in the box.
+ * @param blocksRead Receives the number of blocks read, if not null.
+ * @return Number of records visited.
+ */
+size_t regionSearch(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                    const string& indexName, const function<void(const vector<string>&)>& visit,
+                    size_t* blocksRead) {
+    static string boundsIndexName;
+    static vector<BlockBounds> bounds;
+    if (boundsIndexName != indexName) {
+        bounds.clear();
+        ifstream boundsFile(indexName + ".bounds");
+        if (!boundsFile.is_open()) {
+            cerr << "Error: Could not open " << indexName << ".bounds" << endl;
+            return 0;
+        }
+        BlockBounds entry;
+        while (boundsFile >> entry.RBN >> entry.minLatitude >> entry.minLongitude
+                          >> entry.maxLatitude >> entry.maxLongitude) {
+            bounds.push_back(entry);
+        }
+        boundsIndexName = indexName;
+    }
+
+    // The blocks to read are known up front, so they are read ahead in that order
+    vector<int> overlapping;
+    map<int, int> nextOverlapping;
+    for (const BlockBounds& entry : bounds) {
+        if (entry.maxLatitude < minLatitude || entry.minLatitude > maxLatitude
+            || entry.maxLongitude < minLongitude || entry.minLongitude > maxLongitude) {
+            continue;
+        }
+        if (!overlapping.empty()) {
+            nextOverlapping[overlapping.back()] = entry.RBN;
+        }
+        overlapping.push_back(entry.RBN);
+    }
+    ScanReadAhead readAhead([&nextOverlapping](int RBN) {
+        auto found = nextOverlapping.find(RBN);
+        return found == nextOverlapping.end() ? -1 : found->second;
+    });
+
+    size_t visited = 0;
+    size_t read = 0;
+    vector<string> fields;
+    for (int RBN : overlapping) {
+        readAhead.visit(RBN);
+        Block* block = getBlockByRBN(RBN);
+        if (!block) {
+            continue;
+        }
+        read++;
+        for (size_t i = 0; i + FIELDS_PER_RECORD <= block->records.size(); i += FIELDS_PER_RECORD) {
+            double latitude = strtod(block->records[i + 4].c_str(), nullptr);
+            double longitude = strtod(block->records[i + 5].c_str(), nullptr);
+            if (latitude >= minLatitude && latitude <= maxLatitude
+                && longitude >= minLongitude && longitude <= maxLongitude) {
+                fields.assign(block->records.begin() + i, block->records.begin() + i + FIELDS_PER_RECORD);
+                visit(fields);
+                visited++;
+            }
+        }
+    }
+    METRICS_RECORD(Histogram::BlocksPerQuery, read);
+    if (blocksRead) {
+        *blocksRead = read;
+    }
+    return visited;
+}
+
 /**
  * @brief Creates a new block and inserts it into the global map.
  * 
@@ -463,19 +1805,29 @@ void search(const std::string& str, const std::string& indexName){
  * 
  * @param RBN Relative Block Number of the new block.
  * @param isAvailable Flag indicating whether the block is available (true) or active (false).
- * @param records List of records to store in the block.
+ * @param records List of records to store in the block; moved in, so pass an rvalue to avoid a copy.
  * @param predecessorRBN RBN of the predecessor block in the chain.
  * @param successorRBN RBN of the successor block in the chain.
  */
-void createBlock(int RBN, bool isAvailable, const vector<string>& records, int predecessorRBN, int successorRBN) {
+void createBlock(int RBN, bool isAvailable, vector<string> records, int predecessorRBN, int successorRBN) {
     Block block;
     block.RBN = RBN;
     block.isAvailable = isAvailable;
-    block.records = records;
+    setBlockRecords(block, move(records));
     block.predecessorRBN = predecessorRBN;
     block.successorRBN = successorRBN;
 
-    blocks[RBN] = block;
+    if (stateExtremesBuilt) {
+        auto old = blocks.find(RBN);
+        if (old != blocks.end() && !old->second.isAvailable) {
+            materializeBlock(old->second);
+            stateExtremes.removeRecords(old->second.records);
+        }
+        if (!isAvailable) {
+            stateExtremes.addRecords(block.records);
+        }
+    }
+    blocks[RBN] = move(block);
 
     // Update the global head pointers
     if (!isAvailable && listHeadRBN == -1) {
@@ -15,6 +15,43 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <functional>
+#include "BlockCodec.h"
+#include "KeyColumn.h"
+#include "StringPool.h"
+
+/**
+ * @brief Number of fields making up one zip code record inside a block.
+ */
+const int FIELDS_PER_RECORD = 6;
+
+/**
+ * @brief Order in which `createBlockFile` packs records into blocks.
+ */
+enum class BlockLayout {
+    Zip,     ///< Ascending zip code; the active list is in key order
+    Hilbert  ///< Hilbert curve order of (latitude, longitude); each block is in zip order
+};
+
+/**
+ * @brief When the checksum stored with each block is checked as blocks are read from disk.
+ */
+enum class BlockVerifyMode {
+    Always,   ///< Every block read is checked
+    Sampled,  ///< One block read in every sample interval is checked
+    Off       ///< Checksums are written but never checked on read
+};
+
+/**
+ * @brief Outcome of checking every block of a block file with `verifyBlockFile`.
+ */
+struct BlockFileReport {
+    size_t blocks = 0;              ///< Block lines found
+    size_t unchecked = 0;           ///< Blocks written without a checksum
+    size_t expectedBlocks = 0;      ///< Block count recorded in the header
+    std::vector<int> corruptRBNs;   ///< Blocks whose payload does not match their checksum
+    size_t malformed = 0;           ///< Lines that are not a block at all
+};
 
 /**
  * @struct Block
@@ -30,6 +67,11 @@ struct Block {
     std::vector<std::string> records;  ///< Records stored in the block
     int predecessorRBN;                ///< RBN of the predecessor block in the chain
     int successorRBN;                  ///< RBN of the successor block in the chain
+    std::string encoded;               ///< Encoded payload not yet decoded into `records`
+    KeyColumn keys;                    ///< Zip codes of the records, searchable without the payload
+    long long fileOffset = -1;         ///< Line position in the block file while not yet read, else -1
+    size_t fileLength = 0;             ///< Line length in the block file while not yet read
+    bool corrupt = false;              ///< True if the payload failed its checksum when loaded
 };
 
 /** 
@@ -53,6 +95,14 @@ extern int listHeadRBN;
  */
 extern int availHeadRBN;
 
+/**
+ * @brief Interned city, state and other repeated field values.
+ * 
+ * Shared by the secondary structures built over the block table, so equal
+ * values have equal ids everywhere in the process.
+ */
+extern StringPool fieldStrings;
+
 /**
  * @brief Dumps blocks in physical order based on their RBNs.
  * 
@@ -73,13 +123,41 @@ void dumpLogicalOrder();
  * 
  * @param RBN Relative Block Number of the new block.
  * @param isAvailable Flag indicating whether the block is available (true) or active (false).
- * @param records List of records to store in the block.
+ * @param records List of records to store in the block; moved in, so pass an rvalue to avoid a copy.
  * @param predecessorRBN RBN of the predecessor block in the chain.
  * @param successorRBN RBN of the successor block in the chain.
  * 
  * This function initializes a new block with the provided parameters and adds it to the global map.
  */
-void createBlock(int RBN, bool isAvailable, const std::vector<std::string>& records, int predecessorRBN, int successorRBN);
+void createBlock(int RBN, bool isAvailable, std::vector<std::string> records, int predecessorRBN, int successorRBN);
+
+/**
+ * @brief Empties the global map of blocks and resets both list heads.
+ * 
+ * The state extremes are rebuilt from the next blocks loaded.
+ */
+void clearBlocks();
+
+/**
+ * @brief Opens a block file without reading its blocks.
+ * 
+ * Block positions come from the `<blockFile>.offsets` sidecar written with the
+ * file; each block is read from disk by `materializeBlock` on first access.
+ * Without a sidecar matching the file, the whole file is parsed instead.
+ * 
+ * @param blockFile Path to the block file to open.
+ * @return True if successful, false otherwise.
+ */
+bool openBlockFile(const std::string& blockFile);
+
+/**
+ * @brief Checks whether a block file was built from the current version of a CSV file.
+ * 
+ * @param blockFile Path to the block file.
+ * @param sourceFile Path to the CSV file.
+ * @return True if the fingerprint in the block file header matches the CSV file, false otherwise.
+ */
+bool blockFileMatchesSource(const std::string& blockFile, const std::string& sourceFile);
 
 /**
  * @brief Parses a block file and populates the global map of blocks.
@@ -90,6 +168,120 @@ void createBlock(int RBN, bool isAvailable, const std::vector<std::string>& reco
  */
 void parseBlockFile(const std::string& blockFile);
 
+/**
+ * @brief Parses a block file into a caller owned block table.
+ * 
+ * @param blockFile Path to the block file to parse.
+ * @param table Block table receiving the parsed blocks, chained in file order.
+ * @return RBN of the first block in the file, or -1 if no block was read or a checked block failed its checksum.
+ */
+int loadBlockFile(const std::string& blockFile, std::map<int, Block>& table);
+
+/**
+ * @brief Replays the redo log (`<blockFile>.log`) of a block file into a block table.
+ * 
+ * @param blockFile Path to the block file the log belongs to.
+ * @param table Block table loaded from the block file; new blocks are appended to its active list.
+ * @param headRBN Head of the active list of the table.
+ * @return Number of log entries replayed.
+ */
+size_t replayBlockLog(const std::string& blockFile, std::map<int, Block>& table, int& headRBN);
+
+/**
+ * @brief Reads the payload of a block from disk and decodes it into its records, if necessary.
+ * 
+ * The payload is checked against the checksum stored with the block first,
+ * as the verify mode asks.
+ * 
+ * @param block Block loaded by `loadBlockFile` or `parseBlockFile`.
+ * @return True if the block records are available, false if the payload is malformed or fails its checksum.
+ */
+bool materializeBlock(Block& block);
+
+/**
+ * @brief Replaces the records of a block and rebuilds its key column.
+ * 
+ * @param block Block to update.
+ * @param records New records of the block.
+ */
+void setBlockRecords(Block& block, std::vector<std::string> records);
+
+/**
+ * @brief Retrieves a block by its Relative Block Number (RBN), decoding it on first access.
+ * 
+ * @param requestedRBN The Relative Block Number of the block to retrieve.
+ * @return Pointer to the block if found, nullptr otherwise.
+ */
+Block* getBlockByRBN(int requestedRBN);
+
+/**
+ * @brief Sets when block checksums are checked as blocks are read from disk.
+ * 
+ * @param mode Verify mode; `BlockVerifyMode::Always` by default.
+ * @param sampleInterval In sampled mode, one block read in this many is checked.
+ */
+void setBlockVerifyMode(BlockVerifyMode mode, unsigned sampleInterval = 16);
+
+/**
+ * @brief Sets how many blocks scans read ahead along their path.
+ * 
+ * Scans over a lazily opened block file (`dumpLogicalOrder`, `dumpPhysicalOrder`, 
+ * `listMost` and `regionSearch`) have the blocks they visit next read on a 
+ * background thread while they work on the current one. Takes effect at the 
+ * next `openBlockFile`.
+ * 
+ * @param depth Number of blocks kept requested ahead; 0 reads every block synchronously.
+ */
+void setBlockReadAhead(size_t depth);
+
+/**
+ * @brief Parses a verify mode name given on the command line.
+ * 
+ * @param name "always", "sampled" or "off".
+ * @param mode Receives the mode.
+ * @return True if the name is known, false otherwise.
+ */
+bool blockVerifyModeFromName(const std::string& name, BlockVerifyMode& mode);
+
+/**
+ * @brief Checks the header and the checksum of every block of a block file, in parallel.
+ * 
+ * The file is split into one byte range per thread, and each thread checks
+ * the blocks whose lines start in its range, whatever the verify mode.
+ * 
+ * @param blockFile Path to the block file.
+ * @param threadCount Number of threads; 0 uses one per hardware thread.
+ * @param report Receives the outcome.
+ * @return True if the file could be read and its header is valid, false otherwise.
+ */
+bool verifyBlockFile(const std::string& blockFile, unsigned threadCount, BlockFileReport& report);
+
+/**
+ * @brief Finds the record with a given zip code inside a block.
+ * 
+ * @param block Block to search.
+ * @param zip Zip code to look for.
+ * @param fields Receives the `FIELDS_PER_RECORD` fields of the matching record.
+ * @return True if the record was found, false otherwise.
+ */
+bool findRecordInBlock(const Block& block, const std::string& zip, std::vector<std::string>& fields);
+
+/**
+ * @brief Joins the records of a block into the payload stored in the block file.
+ * 
+ * @param records Records stored in the block.
+ * @return Comma separated records.
+ */
+std::string joinRecords(const std::vector<std::string>& records);
+
+/**
+ * @brief Splits a block payload back into its records.
+ * 
+ * @param payload Comma separated records.
+ * @return Records stored in the block.
+ */
+std::vector<std::string> splitRecords(const std::string& payload);
+
 /**
  * @brief Creates a block file from an input CSV file.
  * 
@@ -98,16 +290,140 @@ void parseBlockFile(const std::string& blockFile);
  * @param inputFile Path to the input CSV file.
  * @param outputFile Path to the output block file.
  * @param BLOCK_SIZE Maximum size of each block in bytes (default is 512).
+ * @param codec Codec used to compress block payloads (default is none).
+ * @param layout Order records are packed in (default is zip code order).
  * @return True if successful, false otherwise.
  */
-bool createBlockFile(const std::string& inputFile, const std::string& outputFile, size_t BLOCK_SIZE = 512);
+bool createBlockFile(const std::string& inputFile, const std::string& outputFile, size_t BLOCK_SIZE = 512,
+                     BlockCodec codec = BlockCodec::None, BlockLayout layout = BlockLayout::Zip);
+
+/**
+ * @brief Gets the name of a layout as stored in the header record.
+ * 
+ * @param layout Layout to name.
+ * @return "zip" or "hilbert".
+ */
+std::string layoutName(BlockLayout layout);
+
+/**
+ * @brief Parses a layout name stored in the header record.
+ * 
+ * @param name Layout name; unknown names map to `BlockLayout::Zip`.
+ * @return The layout.
+ */
+BlockLayout layoutFromName(const std::string& name);
 
+/**
+ * @brief Reads the layout recorded in the header of a block file.
+ * 
+ * @param blockFile Path to the block file.
+ * @return The layout of the file, or `BlockLayout::Zip` if the header cannot be read.
+ */
+BlockLayout blockFileLayout(const std::string& blockFile);
+
+/**
+ * @brief Writes the global map of blocks back to a block file.
+ * 
+ * Active blocks are written in logical order behind a fresh header, through a 
+ * temporary file that replaces the original atomically. Available blocks are left 
+ * out, and the header records an empty available list.
+ * 
+ * @param outputFile Path to the block file to write.
+ * @return True if successful, false otherwise.
+ */
+bool writeBlockFile(const std::string& outputFile);
 
+/**
+ * @brief Writes a block table back to a block file, like `writeBlockFile` does for the global map.
+ * 
+ * @param outputFile Path to the block file to write.
+ * @param table Blocks to write, by RBN.
+ * @param headRBN Head of the active list of the table.
+ * @return True if successful, false otherwise.
+ */
+bool writeBlockFile(const std::string& outputFile, const std::map<int, Block>& table, int headRBN);
 
+/**
+ * @brief Opens the redo log (`<blockFile>.log`) that protects block updates.
+ * 
+ * @param blockFile Path to the block file the log belongs to.
+ * @param fsyncBatchSize Number of logged updates per group commit (one fsync).
+ * @return True if successful, false otherwise.
+ */
+bool openBlockLog(const std::string& blockFile, size_t fsyncBatchSize = 32);
+
+/**
+ * @brief Forces all logged block updates to stable storage.
+ * 
+ * @return True if successful or no log is open, false otherwise.
+ */
+bool flushBlockLog();
+
+/**
+ * @brief Replaces the records of a block after logging the new block image.
+ * 
+ * @param RBN Relative Block Number of the block to update.
+ * @param records New records of the block.
+ * @return True if successful, false otherwise.
+ */
+bool updateBlock(int RBN, const std::vector<std::string>& records);
+
+/**
+ * @brief Writes the in-memory blocks to the block file and empties the redo log.
+ * 
+ * @param blockFile Path to the block file.
+ * @return True if successful, false otherwise.
+ */
+bool checkpointBlockFile(const std::string& blockFile);
+
+/**
+ * @brief Replays the redo log over the parsed blocks and clears the stale flag.
+ * 
+ * @param blockFile Path to the block file, previously loaded with `parseBlockFile`.
+ * @return Number of log entries replayed, or -1 on failure.
+ */
+int recoverBlockFile(const std::string& blockFile);
+
+
+class StateExtremes;
+
+/**
+ * @brief Gets the extreme zip codes of every state over the active blocks.
+ * 
+ * Built from the blocks on the first call and kept current by `updateBlock`
+ * and `createBlock` afterwards.
+ * 
+ * @return Extreme zip codes of every state.
+ */
+const StateExtremes& currentStateExtremes();
+
+/**
+ * @brief Prints the easternmost, westernmost, northernmost and southernmost
+ *        zip code of every state.
+ */
 void listMost();
 
 void search(const std::string& str, const std::string& indexName);
 
+/**
+ * @brief Visits every record inside a latitude/longitude box.
+ * 
+ * Only the blocks whose bounds (`<indexName>.bounds`) overlap the box are read.
+ * 
+ * @param minLatitude Southern edge of the box in degrees.
+ * @param minLongitude Western edge of the box in degrees.
+ * @param maxLatitude Northern edge of the box in degrees.
+ * @param maxLongitude Eastern edge of the box in degrees.
+ * @param indexName Name of the index file written by `Index::processBlockData`.
+ * @param visit Callback receiving the fields of each record in the box.
+ * @param blocksRead Receives the number of blocks read, if not null.
+ * @return Number of records visited.
+ */
+size_t regionSearch(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                    const std::string& indexName,
+                    const std::function<void(const std::vector<std::string>&)>& visit,
+                    size_t* blocksRead = nullptr);
+
 std::vector<std::string> splitZipLine(const std::string& str);
 
 #endif // BLOCK_H
@@ -0,0 +1,227 @@
+#include "BlockCodec.h"
+#include "Block.h"
+#include <iostream>
+#include <map>
+#include <cstdlib>
+
+using namespace std;
+
+/**
+ * @brief Splits a string on a delimiter, keeping empty tokens.
+ *
+ * @param text String to split.
+ * @param delimiter Separator character.
+ * @return Tokens between delimiters, including empty ones.
+ */
+static vector<string> splitKeepEmpty(const string& text, char delimiter) {
+    vector<string> tokens;
+    size_t start = 0;
+    while (true) {
+        size_t end = text.find(delimiter, start);
+        tokens.push_back(text.substr(start, end - start));
+        if (end == string::npos) break;
+        start = end + 1;
+    }
+    return tokens;
+}
+
+/**
+ * @brief Checks that a field holds none of the separators of the encoded form.
+ *
+ * @param field Field to check.
+ * @return True if the field can be stored in an encoded payload.
+ */
+static bool encodable(const string& field) {
+    return field.find_first_of("~|^;,") == string::npos;
+}
+
+/**
+ * @brief Gets the name of a codec as stored in the header record.
+ *
+ * @param codec Codec to name.
+ * @return "none" or "dict".
+ */
+string codecName(BlockCodec codec) {
+    return codec == BlockCodec::Dictionary ? "dict" : "none";
+}
+
+/**
+ * @brief Parses a codec name stored in the header record.
+ *
+ * @param name Codec name; unknown names map to `BlockCodec::None`.
+ * @return The codec.
+ */
+BlockCodec codecFromName(const string& name) {
+    return name == "dict" ? BlockCodec::Dictionary : BlockCodec::None;
+}
+
+/**
+ * @brief Checks whether a payload uses an encoded form.
+ *
+ * @param payload Payload read from the block file.
+ * @return True if the payload must be decoded, false if it is raw.
+ */
+bool isEncodedPayload(const string& payload) {
+    return !payload.empty() && payload[0] == '~';
+}
+
+/**
+ * @brief Encodes the records of a block.
+ *
+ * Zip codes become a base plus signed deltas, and the city, state and county of
+ * each record become positions in a dictionary of the distinct strings of the
+ * block. Neighbouring zips share most of these strings, so they are stored once.
+ *
+ * @param records Flat list of record fields, `FIELDS_PER_RECORD` per record.
+ * @param codec Codec to try.
+ * @return The payload to store in the block file.
+ */
+string encodeBlockPayload(const vector<string>& records, BlockCodec codec) {
+    string raw = joinRecords(records);
+    if (codec == BlockCodec::None || records.empty() || records.size() % FIELDS_PER_RECORD != 0) {
+        return raw;
+    }
+
+    string zips, rows;
+    map<string, size_t> positions;  ///< Dictionary position of each distinct string
+    vector<string> dictionary;      ///< Distinct strings in order of first use
+    long previousZip = 0;
+
+    for (size_t i = 0; i < records.size(); i += FIELDS_PER_RECORD) {
+        const string& zip = records[i];
+        char* end = nullptr;
+        long zipValue = strtol(zip.c_str(), &end, 10);
+        if (zip.empty() || *end != '\0' || to_string(zipValue) != zip) {
+            return raw;  // Only canonical numeric zip codes can be delta encoded
+        }
+        if (i == 0) {
+            zips += zip;
+        } else {
+            long delta = zipValue - previousZip;
+            zips += (delta >= 0 ? "+" : "") + to_string(delta);
+        }
+        previousZip = zipValue;
+
+        if (i > 0) rows += ";";
+        for (int field = 1; field < FIELDS_PER_RECORD; field++) {
+            const string& value = records[i + field];
+            if (!encodable(value)) {
+                return raw;
+            }
+            if (field > 1) rows += ",";
+            if (field <= 3) {
+                auto inserted = positions.emplace(value, dictionary.size());
+                if (inserted.second) {
+                    dictionary.push_back(value);
+                }
+                rows += to_string(inserted.first->second);
+            } else {
+                rows += value;
+            }
+        }
+    }
+
+    string encoded = "~" + zips + "|";
+    for (size_t i = 0; i < dictionary.size(); i++) {
+        if (i > 0) encoded += "^";
+        encoded += dictionary[i];
+    }
+    encoded += "|" + rows;
+
+    return encoded.size() < raw.size() ? encoded : raw;
+}
+
+/**
+ * @brief Decodes only the zip codes of a payload, without touching the record fields.
+ *
+ * @param payload Payload read from the block file, raw or encoded.
+ * @param zips Receives the zip codes in record order.
+ * @return True if successful, false if the payload or a zip code is malformed.
+ */
+bool decodeZipColumn(const string& payload, vector<int>& zips) {
+    zips.clear();
+    if (!isEncodedPayload(payload)) {
+        vector<string> fields = splitRecords(payload);
+        for (size_t i = 0; i + FIELDS_PER_RECORD <= fields.size(); i += FIELDS_PER_RECORD) {
+            char* end = nullptr;
+            long zip = strtol(fields[i].c_str(), &end, 10);
+            if (fields[i].empty() || *end != '\0') {
+                return false;
+            }
+            zips.push_back(static_cast<int>(zip));
+        }
+        return true;
+    }
+
+    size_t columnEnd = payload.find('|');
+    if (columnEnd == string::npos) {
+        return false;
+    }
+    string column = payload.substr(1, columnEnd - 1);
+    const char* cursor = column.c_str();
+    long zip = 0;
+    while (*cursor != '\0') {
+        char* end = nullptr;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor) {
+            return false;
+        }
+        zip = zips.empty() ? value : zip + value;
+        zips.push_back(static_cast<int>(zip));
+        cursor = end;
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes a block payload written by `encodeBlockPayload`.
+ *
+ * @param payload Payload read from the block file, raw or encoded.
+ * @return Flat list of record fields, or an empty list if the payload is malformed.
+ */
+vector<string> decodeBlockPayload(const string& payload) {
+    if (!isEncodedPayload(payload)) {
+        return splitRecords(payload);
+    }
+
+    vector<string> sections = splitKeepEmpty(payload.substr(1), '|');
+    if (sections.size() != 3) {
+        cerr << "Error: Malformed encoded block payload." << endl;
+        return {};
+    }
+    vector<string> dictionary = splitKeepEmpty(sections[1], '^');
+    vector<string> rows = splitKeepEmpty(sections[2], ';');
+
+    vector<string> records;
+    records.reserve(rows.size() * FIELDS_PER_RECORD);
+    const char* cursor = sections[0].c_str();
+    long zip = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+        char* end = nullptr;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor) {
+            cerr << "Error: Malformed zip column in encoded block payload." << endl;
+            return {};
+        }
+        zip = (i == 0) ? value : zip + value;
+        cursor = end;
+
+        vector<string> fields = splitKeepEmpty(rows[i], ',');
+        if (fields.size() != FIELDS_PER_RECORD - 1) {
+            cerr << "Error: Malformed row in encoded block payload." << endl;
+            return {};
+        }
+        records.push_back(to_string(zip));
+        for (int field = 0; field < 3; field++) {
+            size_t position = strtoul(fields[field].c_str(), nullptr, 10);
+            if (position >= dictionary.size()) {
+                cerr << "Error: Dictionary position out of range in encoded block payload." << endl;
+                return {};
+            }
+            records.push_back(dictionary[position]);
+        }
+        records.push_back(fields[3]);
+        records.push_back(fields[4]);
+    }
+    return records;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file BlockCodec.h
+ * @brief Declaration of the per-block payload codecs of the block file.
+ *
+ * A block payload is either the raw comma separated record list or, when the
+ * dictionary codec makes it smaller, an encoded form that starts with `~`. Every
+ * block carries its own tag, so raw and encoded blocks can be mixed in one file.
+ *
+ * The dictionary form is `~<zips>|<dictionary>|<rows>` where
+ * - `<zips>` is the first zip code followed by signed deltas (`501+43+457`),
+ * - `<dictionary>` lists the distinct city, state and county strings of the block separated by `^`,
+ * - `<rows>` holds one `city,state,county,latitude,longitude` entry per record separated by `;`,
+ *   with the three text fields given as dictionary positions.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Codec used when writing block payloads.
+ */
+enum class BlockCodec {
+    None,       ///< Records are stored as plain comma separated text
+    Dictionary  ///< Zip codes are delta encoded and text fields dictionary encoded
+};
+
+/**
+ * @brief Gets the name of a codec as stored in the header record.
+ * @param codec Codec to name.
+ * @return "none" or "dict".
+ */
+std::string codecName(BlockCodec codec);
+
+/**
+ * @brief Parses a codec name stored in the header record.
+ * @param name Codec name; unknown names map to `BlockCodec::None`.
+ * @return The codec.
+ */
+BlockCodec codecFromName(const std::string& name);
+
+/**
+ * @brief Encodes the records of a block.
+ *
+ * Falls back to the raw form if the block cannot be encoded or the encoded form
+ * would not be smaller.
+ *
+ * @param records Flat list of record fields, `FIELDS_PER_RECORD` per record.
+ * @param codec Codec to try.
+ * @return The payload to store in the block file.
+ */
+std::string encodeBlockPayload(const std::vector<std::string>& records, BlockCodec codec);
+
+/**
+ * @brief Decodes a block payload written by `encodeBlockPayload`.
+ * @param payload Payload read from the block file, raw or encoded.
+ * @return Flat list of record fields.
+ */
+std::vector<std::string> decodeBlockPayload(const std::string& payload);
+
+/**
+ * @brief Decodes only the zip codes of a payload, without touching the record fields.
+ * @param payload Payload read from the block file, raw or encoded.
+ * @param zips Receives the zip codes in record order.
+ * @return True if successful, false if the payload or a zip code is malformed.
+ */
+bool decodeZipColumn(const std::string& payload, std::vector<int>& zips);
+
+/**
+ * @brief Checks whether a payload uses an encoded form.
+ * @param payload Payload read from the block file.
+ * @return True if the payload must be decoded, false if it is raw.
+ */
+bool isEncodedPayload(const std::string& payload);
+
+#endif // BLOCK_CODEC_H
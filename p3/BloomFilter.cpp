@@ -0,0 +1,135 @@
+#include "BloomFilter.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Constructs an empty filter that cannot answer queries until sized or loaded.
+ */
+BloomFilter::BloomFilter() : bitCount(0), hashCount(0) {}
+
+/**
+ * @brief Sizes an empty filter for a number of keys.
+ *
+ * @param expectedKeys Number of keys that will be added.
+ * @param bitsPerKey Bits of filter per key; 10 gives about a 1% false positive rate.
+ */
+void BloomFilter::reset(size_t expectedKeys, size_t bitsPerKey) {
+    if (bitsPerKey == 0) bitsPerKey = 1;
+    size_t wordCount = (max<size_t>(expectedKeys, 1) * bitsPerKey + 63) / 64;
+    words.assign(wordCount, 0);
+    bitCount = wordCount * 64;
+    // ln 2 * bits per key minimises the false positive rate
+    hashCount = static_cast<unsigned>(max(1.0, round(bitsPerKey * 0.69)));
+}
+
+/**
+ * @brief Hashes a key into a 64 bit value.
+ *
+ * @param key Key to hash.
+ * @return Well mixed hash of the key.
+ */
+uint64_t BloomFilter::hashKey(int key) {
+    uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(key)) + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Adds a key to the filter.
+ *
+ * @param key Key to add.
+ */
+void BloomFilter::add(int key) {
+    if (!isReady()) return;
+    uint64_t hash = hashKey(key);
+    uint64_t step = (hash >> 32) | 1;
+    for (unsigned i = 0; i < hashCount; i++) {
+        uint64_t bit = hash % bitCount;
+        words[bit / 64] |= 1ULL << (bit % 64);
+        hash += step;
+    }
+}
+
+/**
+ * @brief Checks whether a key may have been added.
+ *
+ * @param key Key to check.
+ * @return False if the key was definitely never added, true otherwise.
+ */
+bool BloomFilter::mightContain(int key) const {
+    if (!isReady()) return true;
+    uint64_t hash = hashKey(key);
+    uint64_t step = (hash >> 32) | 1;
+    for (unsigned i = 0; i < hashCount; i++) {
+        uint64_t bit = hash % bitCount;
+        if ((words[bit / 64] & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+        hash += step;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the filter to a file.
+ *
+ * @param filename Path of the filter file.
+ * @return True if successful, false otherwise.
+ */
+bool BloomFilter::save(const string& filename) const {
+    ofstream out(filename);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open " << filename << endl;
+        return false;
+    }
+    out << "bloom " << bitCount << " " << hashCount << "\n";
+    out << hex << setfill('0');
+    for (uint64_t word : words) {
+        out << setw(16) << word;
+    }
+    out << "\n";
+    return out.good();
+}
+
+/**
+ * @brief Reads a filter written by `save`.
+ *
+ * @param filename Path of the filter file.
+ * @return True if successful, false if the file is missing or malformed.
+ */
+bool BloomFilter::load(const string& filename) {
+    ifstream in(filename);
+    if (!in.is_open()) {
+        return false;
+    }
+    string tag, bits;
+    uint64_t newBitCount = 0;
+    unsigned newHashCount = 0;
+    if (!(in >> tag >> newBitCount >> newHashCount >> bits) || tag != "bloom"
+        || newBitCount == 0 || newBitCount % 64 != 0 || newHashCount == 0
+        || bits.size() != newBitCount / 4) {
+        cerr << "Error: Malformed Bloom filter file " << filename << endl;
+        return false;
+    }
+
+    vector<uint64_t> newWords(newBitCount / 64);
+    for (size_t i = 0; i < newWords.size(); i++) {
+        try {
+            newWords[i] = stoull(bits.substr(i * 16, 16), nullptr, 16);
+        }
+        catch (const exception&) {
+            cerr << "Error: Malformed Bloom filter file " << filename << endl;
+            return false;
+        }
+    }
+    words = move(newWords);
+    bitCount = newBitCount;
+    hashCount = newHashCount;
+    return true;
+}
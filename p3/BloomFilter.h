@@ -0,0 +1,86 @@
+/**
+ * @file BloomFilter.h
+ * @brief Declaration of the Bloom filter kept next to the index file.
+ *
+ * The filter answers "definitely absent" or "possibly present" for a zip code.
+ * `Index::processBlockData` builds it over every zip of the block file and saves
+ * it as `<index>.bloom`, so `search` can reject a retired or invalid zip without
+ * reading the index or the block file. `updateBlock` adds the zips it installs to
+ * the filter `search` holds in memory until the index is rebuilt.
+ *
+ * The file holds one line `bloom <bitCount> <hashCount>` followed by one line of
+ * hexadecimal filter words.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class BloomFilter
+ * @brief Bit array Bloom filter over integer keys using double hashing.
+ */
+class BloomFilter {
+public:
+    BloomFilter();
+
+    /**
+     * @brief Sizes an empty filter for a number of keys.
+     * @param expectedKeys Number of keys that will be added.
+     * @param bitsPerKey Bits of filter per key; 10 gives about a 1% false positive rate.
+     */
+    void reset(size_t expectedKeys, size_t bitsPerKey = 10);
+
+    /**
+     * @brief Adds a key to the filter.
+     * @param key Key to add.
+     */
+    void add(int key);
+
+    /**
+     * @brief Checks whether a key may have been added.
+     * @param key Key to check.
+     * @return False if the key was definitely never added, true otherwise.
+     */
+    bool mightContain(int key) const;
+
+    /**
+     * @brief Writes the filter to a file.
+     * @param filename Path of the filter file.
+     * @return True if successful, false otherwise.
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief Reads a filter written by `save`.
+     * @param filename Path of the filter file.
+     * @return True if successful, false if the file is missing or malformed.
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * @brief Checks whether the filter has been sized or loaded.
+     * @return True if the filter can answer queries.
+     */
+    bool isReady() const { return bitCount > 0; }
+
+    /**
+     * @brief Hashes a key into a 64 bit value.
+     * @param key Key to hash.
+     * @return Well mixed hash of the key.
+     */
+    static uint64_t hashKey(int key);
+
+private:
+    std::vector<uint64_t> words;  ///< Filter bits
+    uint64_t bitCount;            ///< Number of usable bits
+    unsigned hashCount;           ///< Number of bit positions set per key
+};
+
+#endif // BLOOM_FILTER_H
@@ -1,4 +1,5 @@
 #include "Buffer.h"
+#include "Metrics.h"
 #include <iostream>
 #include <sstream>
 #include <iterator>
@@ -70,8 +71,7 @@ bool Buffer::read_csv(const std::string& csv_filename, size_t records_per_block)
     size_t record_count = 0;
 
     while (std::getline(file, line)) {
-        ZipCodeRecord record = parse_csv_line(line);
-        add_record(block_number, record);
+        add_record(block_number, parse_csv_line(line));
 
         if (++record_count >= records_per_block) {
             block_number++;
@@ -91,6 +91,8 @@ bool Buffer::read_csv(const std::string& csv_filename, size_t records_per_block)
  * @return ZipCodeRecord The parsed ZipCodeRecord.
  */
 ZipCodeRecord Buffer::parse_csv_line(const std::string& line) const {
+    METRICS_TIME(Histogram::RecordParse);
+    METRICS_COUNT(Counter::RecordsParsed, 1);
     std::stringstream ss(line);
     std::string token;
     ZipCodeRecord record;
@@ -98,6 +100,7 @@ ZipCodeRecord Buffer::parse_csv_line(const std::string& line) const {
     std::getline(ss, record.zip_code, ',');
     std::getline(ss, record.city, ',');
     std::getline(ss, record.state_id, ',');
+    std::getline(ss, token, ',');  // Skip the county
     std::getline(ss, token, ',');
     record.latitude = std::stod(token);
     std::getline(ss, token, ',');
@@ -152,24 +155,33 @@ void Buffer::sort_records() {
  * @brief Adds a ZipCodeRecord to a specific block and the main records list.
  * 
  * @param block_number The block number to which the record should be added.
- * @param record The ZipCodeRecord to be added.
+ * @param record The ZipCodeRecord to be added; moved into the records list after its block copy is made.
  */
-void Buffer::add_record(size_t block_number, const ZipCodeRecord& record) {
-    blocks[block_number][record.zip_code] = record;
-    records.push_back(record);
+void Buffer::add_record(size_t block_number, ZipCodeRecord record) {
+    blocks[block_number].insert_or_assign(record.zip_code, record);
+    records.push_back(std::move(record));
 }
 
 /**
  * @brief Retrieves all blocks of ZipCodeRecords.
  * 
- * @return std::unordered_map<size_t, std::unordered_map<std::string, ZipCodeRecord>> 
+ * @return const std::unordered_map<size_t, std::unordered_map<std::string, ZipCodeRecord>>& 
  * A map where the key is the block number and the value is a map of ZipCodeRecords 
  * within that block.
  */
-std::unordered_map<size_t, std::unordered_map<std::string, ZipCodeRecord>> Buffer::get_blocks() const {
+const std::unordered_map<size_t, std::unordered_map<std::string, ZipCodeRecord>>& Buffer::get_blocks() const {
     return blocks;
 }
 
+/**
+ * @brief Retrieves all records in the order they were read.
+ * 
+ * @return const std::vector<ZipCodeRecord>& The flat list of records.
+ */
+const std::vector<ZipCodeRecord>& Buffer::get_records() const {
+    return records;
+}
+
 /**
  * @brief Prints the contents of each block for debugging purposes.
  */
@@ -97,13 +97,19 @@ public:
      * @param block_number The block number to which the record should be added.
      * @param record The ZipCodeRecord to be added.
      */
-    void add_record(size_t block_number, const ZipCodeRecord& record);
+    void add_record(size_t block_number, ZipCodeRecord record);
 
     /**
      * @brief Retrieves all blocks of ZipCodeRecords.
      * @return A map where the key is the block number, and the value is a map of ZipCodeRecords.
      */
-    std::unordered_map<size_t, std::unordered_map<std::string, ZipCodeRecord>> get_blocks() const;
+    const std::unordered_map<size_t, std::unordered_map<std::string, ZipCodeRecord>>& get_blocks() const;
+
+    /**
+     * @brief Retrieves all records in the order they were read.
+     * @return The flat list of ZipCodeRecords.
+     */
+    const std::vector<ZipCodeRecord>& get_records() const;
 
     /**
      * @brief Prints the contents of each block for debugging purposes.
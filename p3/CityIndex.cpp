@@ -0,0 +1,195 @@
+#include "CityIndex.h"
+#include "Block.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * @brief Constructs an empty index.
+ */
+CityIndex::CityIndex() : sorted(true) {}
+
+/**
+ * @brief Normalizes a city name for comparison.
+ *
+ * Words followed by another word are expanded when they are a common
+ * abbreviation ("st" becomes "saint"), so "St. Louis" finds "Saint Louis"
+ * while a partly typed "st" still finds "Stamford".
+ *
+ * @param city City name.
+ * @return Lowercase letters and digits, with words separated by single spaces.
+ */
+string CityIndex::normalize(const string& city) {
+    vector<string> words(1);
+    for (unsigned char c : city) {
+        if (isalnum(c)) {
+            words.back() += static_cast<char>(tolower(c));
+        } else if ((isspace(c) || c == '-' || c == '.') && !words.back().empty()) {
+            words.emplace_back();
+        }
+    }
+    if (words.back().empty()) {
+        words.pop_back();
+    }
+
+    string key;
+    for (size_t i = 0; i < words.size(); i++) {
+        string word = words[i];
+        if (i + 1 < words.size()) {
+            if (word == "st") word = "saint";
+            else if (word == "ft") word = "fort";
+            else if (word == "mt") word = "mount";
+        }
+        if (!key.empty()) key += ' ';
+        key += word;
+    }
+    return key;
+}
+
+/**
+ * @brief Adds a record to the index.
+ *
+ * @param city City name of the record.
+ * @param state State of the record.
+ * @param zip Zip code of the record.
+ * @param RBN Block holding the record.
+ */
+void CityIndex::add(const string& city, const string& state, int zip, int RBN) {
+    entries.push_back(makeEntry(city, state, zip, RBN));
+    sorted = false;
+}
+
+/**
+ * @brief Builds an entry whose names are interned in `fieldStrings`.
+ *
+ * @param city City name of the record.
+ * @param state State of the record.
+ * @param zip Zip code of the record.
+ * @param RBN Block holding the record.
+ * @return The entry.
+ */
+CityEntry CityIndex::makeEntry(const string& city, const string& state, int zip, int RBN) {
+    CityEntry entry;
+    entry.keyId = fieldStrings.intern(normalize(city));
+    entry.key = fieldStrings.text(entry.keyId);
+    entry.city = fieldStrings.text(fieldStrings.intern(city));
+    entry.state = fieldStrings.text(fieldStrings.intern(state));
+    entry.zip = zip;
+    entry.RBN = RBN;
+    return entry;
+}
+
+/**
+ * @brief Puts the records in lookup order: by normalized city, then zip code.
+ */
+void CityIndex::sortEntries() const {
+    if (sorted) {
+        return;
+    }
+    sort(entries.begin(), entries.end(), [](const CityEntry& a, const CityEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.zip < b.zip;
+    });
+    sorted = true;
+}
+
+/**
+ * @brief Writes the index to a file.
+ *
+ * @param filename Path of the city index file.
+ * @return True if successful, false otherwise.
+ */
+bool CityIndex::save(const string& filename) {
+    sortEntries();
+    ofstream out(filename);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open " << filename << endl;
+        return false;
+    }
+    for (const CityEntry& entry : entries) {
+        out << entry.zip << " " << entry.RBN << " " << entry.state << " " << entry.city << "\n";
+    }
+    return out.good();
+}
+
+/**
+ * @brief Reads an index written by `save`, replacing the current content.
+ *
+ * @param filename Path of the city index file.
+ * @return True if successful, false if the file is missing or malformed.
+ */
+bool CityIndex::load(const string& filename) {
+    ifstream in(filename);
+    if (!in.is_open()) {
+        return false;
+    }
+    entries.clear();
+    string line;
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        istringstream fields(line);
+        int zip, RBN;
+        string state, city;
+        if (!(fields >> zip >> RBN >> state)) {
+            cerr << "Error: Malformed city index file " << filename << endl;
+            entries.clear();
+            return false;
+        }
+        getline(fields >> ws, city);
+        entries.push_back(makeEntry(city, state, zip, RBN));
+    }
+    sorted = false;
+    sortEntries();
+    return true;
+}
+
+/**
+ * @brief Finds the records of a city.
+ *
+ * @param city City name; normalized before the lookup.
+ * @param k Largest number of records to return.
+ * @return Up to k records ordered by zip code.
+ */
+vector<const CityEntry*> CityIndex::exact(const string& city, size_t k) const {
+    sortEntries();
+    vector<const CityEntry*> matches;
+    uint32_t keyId;
+    if (!fieldStrings.find(normalize(city), keyId)) {
+        return matches;  // No record has this name
+    }
+    string_view key = fieldStrings.text(keyId);
+    auto first = lower_bound(entries.begin(), entries.end(), key,
+                             [](const CityEntry& entry, string_view value) { return entry.key < value; });
+    for (auto entry = first; entry != entries.end() && entry->keyId == keyId && matches.size() < k; ++entry) {
+        matches.push_back(&*entry);
+    }
+    return matches;
+}
+
+/**
+ * @brief Finds the records whose city starts with a prefix.
+ *
+ * Every key with the prefix sorts at or after the prefix itself, and the keys
+ * that share it are contiguous, so the scan stops at the first key without it.
+ *
+ * @param prefix Start of the city name; normalized before the lookup.
+ * @param k Largest number of records to return.
+ * @return Up to k records ordered by city and zip code.
+ */
+vector<const CityEntry*> CityIndex::prefix(const string& prefix, size_t k) const {
+    sortEntries();
+    string key = normalize(prefix);
+    vector<const CityEntry*> matches;
+    auto first = lower_bound(entries.begin(), entries.end(), key,
+                             [](const CityEntry& entry, string_view value) { return entry.key < value; });
+    for (auto entry = first; entry != entries.end() && matches.size() < k; ++entry) {
+        if (entry->key.compare(0, key.size(), key) != 0) {
+            break;
+        }
+        matches.push_back(&*entry);
+    }
+    return matches;
+}
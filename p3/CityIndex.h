@@ -0,0 +1,107 @@
+/**
+ * @file CityIndex.h
+ * @brief Declaration of the secondary index on city name.
+ *
+ * The index is a sorted array of (normalized city, zip) entries, so exact and
+ * prefix lookups are a binary search followed by a short forward scan.
+ * Normalizing lowercases the name, drops punctuation and spells out st, ft
+ * and mt, so "st. louis", "St Louis" and "SAINT LOUIS" find the same records. `Index::processBlockData`
+ * builds it next to the primary index and saves it as `<index>.city`, one
+ * "zip RBN state city" line per record in lookup order. Records added after a
+ * load or save are sorted by the next lookup. Names are interned in
+ * `fieldStrings`, so each entry holds views of one shared copy and exact
+ * matches compare ids.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef CITY_INDEX_H
+#define CITY_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief One record of the city index.
+ */
+struct CityEntry {
+    std::string_view key;    ///< Normalized city name, interned in `fieldStrings`
+    std::string_view city;   ///< City name as stored in the record, interned
+    std::string_view state;  ///< State of the record, interned
+    uint32_t keyId;          ///< Id of `key` in `fieldStrings`
+    int zip;                 ///< Zip code of the record
+    int RBN;                 ///< Block holding the record
+};
+
+/**
+ * @class CityIndex
+ * @brief Sorted (normalized city, zip) array with exact and prefix lookups.
+ */
+class CityIndex {
+public:
+    CityIndex();
+
+    /**
+     * @brief Adds a record to the index.
+     * @param city City name of the record.
+     * @param state State of the record.
+     * @param zip Zip code of the record.
+     * @param RBN Block holding the record.
+     */
+    void add(const std::string& city, const std::string& state, int zip, int RBN);
+
+    /**
+     * @brief Writes the index to a file.
+     * @param filename Path of the city index file.
+     * @return True if successful, false otherwise.
+     */
+    bool save(const std::string& filename);
+
+    /**
+     * @brief Reads an index written by `save`, replacing the current content.
+     * @param filename Path of the city index file.
+     * @return True if successful, false if the file is missing or malformed.
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * @brief Finds the records of a city.
+     * @param city City name; normalized before the lookup.
+     * @param k Largest number of records to return.
+     * @return Up to k records ordered by zip code.
+     */
+    std::vector<const CityEntry*> exact(const std::string& city, size_t k) const;
+
+    /**
+     * @brief Finds the records whose city starts with a prefix.
+     * @param prefix Start of the city name; normalized before the lookup.
+     * @param k Largest number of records to return.
+     * @return Up to k records ordered by city and zip code.
+     */
+    std::vector<const CityEntry*> prefix(const std::string& prefix, size_t k) const;
+
+    /**
+     * @brief Gets the number of records in the index.
+     * @return Number of records.
+     */
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Normalizes a city name for comparison.
+     * @param city City name.
+     * @return Lowercase letters and digits, with words separated by single spaces.
+     */
+    static std::string normalize(const std::string& city);
+
+private:
+    mutable std::vector<CityEntry> entries;  ///< Records sorted by key and zip once `sorted` is set
+    mutable bool sorted;                     ///< True if `entries` is in lookup order
+
+    void sortEntries() const;
+    static CityEntry makeEntry(const std::string& city, const std::string& state, int zip, int RBN);
+};
+
+#endif // CITY_INDEX_H
@@ -0,0 +1,127 @@
+/**
+ * @file Crc32c.cpp
+ * @brief CRC-32C with the SSE4.2 crc32 instruction, falling back to a table.
+ *
+ * The instruction computes exactly CRC-32C, eight bytes per step. Whether
+ * the processor has it is checked once at run time, so the same binary also
+ * runs on machines without SSE4.2 and on other architectures, where the
+ * table version is used.
+ *
+ * @date 10/18/2026
+ */
+
+#include "Crc32c.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define CRC32C_HAVE_SSE42 1
+#endif
+
+using namespace std;
+
+/**
+ * @brief Reflected CRC-32C polynomial.
+ */
+static const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+/**
+ * @brief Builds the table of the checksum of every byte value.
+ *
+ * @return Pointer to the 256 entry table, built on first use.
+ */
+static const uint32_t* crcTable() {
+    static uint32_t table[256];
+    static bool built = [] {
+        for (uint32_t byte = 0; byte < 256; byte++) {
+            uint32_t crc = byte;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+            }
+            table[byte] = crc;
+        }
+        return true;
+    }();
+    (void)built;
+    return table;
+}
+
+/**
+ * @brief Table driven CRC-32C, one byte per step.
+ *
+ * @param crc Inverted checksum of the bytes seen so far.
+ * @param bytes Next bytes to checksum.
+ * @param length Number of bytes.
+ * @return Inverted checksum of all bytes seen.
+ */
+static uint32_t crc32cTable(uint32_t crc, const unsigned char* bytes, size_t length) {
+    const uint32_t* table = crcTable();
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef CRC32C_HAVE_SSE42
+/**
+ * @brief CRC-32C with the SSE4.2 crc32 instruction, eight bytes per step.
+ *
+ * @param crc Inverted checksum of the bytes seen so far.
+ * @param bytes Next bytes to checksum.
+ * @param length Number of bytes.
+ * @return Inverted checksum of all bytes seen.
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(uint32_t crc, const unsigned char* bytes, size_t length) {
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    for (; length >= 8; bytes += 8, length -= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; length >= 4; bytes += 4, length -= 4) {
+        uint32_t word;
+        memcpy(&word, bytes, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    for (; length > 0; bytes++, length--) {
+        crc = _mm_crc32_u8(crc, *bytes);
+    }
+    return crc;
+}
+#endif
+
+/**
+ * @brief Extends a CRC-32C checksum over more bytes.
+ *
+ * @param crc Checksum of the bytes seen so far.
+ * @param data Next bytes to checksum.
+ * @param length Number of bytes.
+ * @return Checksum of all bytes seen.
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+#ifdef CRC32C_HAVE_SSE42
+    static const bool hardware = __builtin_cpu_supports("sse4.2");
+    if (hardware) {
+        return ~crc32cHardware(~crc, bytes, length);
+    }
+#endif
+    return ~crc32cTable(~crc, bytes, length);
+}
+
+/**
+ * @brief Tells whether crc32c uses the SSE4.2 instruction on this machine.
+ *
+ * @return True if the hardware version is used, false if the table version is.
+ */
+bool crc32cHardwareAccelerated() {
+#ifdef CRC32C_HAVE_SSE42
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
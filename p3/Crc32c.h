@@ -0,0 +1,34 @@
+/**
+ * @file Crc32c.h
+ * @brief CRC-32C (Castagnoli) checksum used to detect corrupted file headers and blocks.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Extends a CRC-32C checksum over more bytes.
+ *
+ * Start with a crc of 0 and feed the data in one or more pieces; the result
+ * is the same as checksumming all of it at once.
+ *
+ * @param crc Checksum of the bytes seen so far.
+ * @param data Next bytes to checksum.
+ * @param length Number of bytes.
+ * @return Checksum of all bytes seen.
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t length);
+
+/**
+ * @brief Tells whether crc32c uses the SSE4.2 instruction on this machine.
+ *
+ * @return True if the hardware version is used, false if the table version is.
+ */
+bool crc32cHardwareAccelerated();
+
+#endif // CRC32C_H
@@ -0,0 +1,127 @@
+#include "EpochManager.h"
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Transfers a pinned epoch to a new guard.
+ *
+ * @param other Guard giving up its pin.
+ */
+EpochManager::Guard::Guard(Guard&& other) noexcept : slot(other.slot) {
+    other.slot = nullptr;
+}
+
+/**
+ * @brief Unpins the epoch held by the guard.
+ */
+EpochManager::Guard::~Guard() {
+    if (slot) {
+        slot->store(0, memory_order_release);
+    }
+}
+
+/**
+ * @brief Creates a manager with a fixed number of concurrent reader slots.
+ *
+ * @param maxReaders Number of readers that can be pinned at the same time.
+ */
+EpochManager::EpochManager(size_t maxReaders)
+    : globalEpoch(1)
+    , slots(new Slot[maxReaders == 0 ? 1 : maxReaders])
+    , slotCount(maxReaders == 0 ? 1 : maxReaders) {}
+
+/**
+ * @brief Frees everything that is still retired.
+ *
+ * No reader may be pinned when the manager is destroyed.
+ */
+EpochManager::~EpochManager() {
+    for (auto& entry : retired) {
+        entry.second();
+    }
+}
+
+/**
+ * @brief Pins the current epoch.
+ *
+ * The epoch is published in a free reader slot before the caller reads any
+ * shared pointer, so a writer that retires an object afterwards will keep it
+ * alive until the guard is released.
+ *
+ * @return Guard that unpins the epoch when destroyed.
+ */
+EpochManager::Guard EpochManager::pin() {
+    size_t start = hash<thread::id>()(this_thread::get_id()) % slotCount;
+    while (true) {
+        for (size_t n = 0; n < slotCount; n++) {
+            Slot& slot = slots[(start + n) % slotCount];
+            uint64_t expected = 0;
+            uint64_t epoch = globalEpoch.load();
+            if (slot.epoch.load(memory_order_relaxed) == 0 &&
+                slot.epoch.compare_exchange_strong(expected, epoch)) {
+                return Guard(&slot.epoch);
+            }
+        }
+        this_thread::yield();
+    }
+}
+
+/**
+ * @brief Defers freeing an object that readers may still reference.
+ *
+ * The caller must already have unlinked the object from every shared pointer.
+ *
+ * @param reclaim Callback that frees the object once no reader can see it.
+ */
+void EpochManager::retire(function<void()> reclaim) {
+    uint64_t epoch = globalEpoch.fetch_add(1);
+    lock_guard<mutex> guard(retireLatch);
+    retired.emplace_back(epoch, move(reclaim));
+}
+
+/**
+ * @brief Frees retired objects that are no longer visible to any reader.
+ *
+ * An object retired in epoch E may still be held by readers pinned at E or
+ * earlier, so it is freed only when every pinned epoch is greater than E.
+ *
+ * @return Number of objects freed.
+ */
+size_t EpochManager::reclaim() {
+    uint64_t oldestPinned = UINT64_MAX;
+    for (size_t n = 0; n < slotCount; n++) {
+        uint64_t epoch = slots[n].epoch.load();
+        if (epoch != 0 && epoch < oldestPinned) {
+            oldestPinned = epoch;
+        }
+    }
+
+    vector<function<void()>> ready;
+    {
+        lock_guard<mutex> guard(retireLatch);
+        size_t kept = 0;
+        for (auto& entry : retired) {
+            if (entry.first < oldestPinned) {
+                ready.push_back(move(entry.second));
+            } else {
+                retired[kept++] = move(entry);
+            }
+        }
+        retired.resize(kept);
+    }
+
+    for (auto& free : ready) {
+        free();
+    }
+    return ready.size();
+}
+
+/**
+ * @brief Gets the number of retired objects waiting to be freed.
+ * @return Number of pending objects.
+ */
+size_t EpochManager::pendingReclaims() const {
+    lock_guard<mutex> guard(retireLatch);
+    return retired.size();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file EpochManager.h
+ * @brief Declaration of epoch-based reclamation for lock-free readers.
+ *
+ * Readers pin the current epoch while they hold pointers into shared data.
+ * Writers retire replaced objects with the epoch in which they were unlinked,
+ * and an object is freed only once every pinned reader has moved past it.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef EPOCH_MANAGER_H
+#define EPOCH_MANAGER_H
+
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @class EpochManager
+ * @brief Tracks reader epochs and defers freeing retired objects.
+ */
+class EpochManager {
+public:
+    /**
+     * @class Guard
+     * @brief Keeps an epoch pinned for as long as it is alive.
+     */
+    class Guard {
+    public:
+        Guard(Guard&& other) noexcept;
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+    private:
+        friend class EpochManager;
+        explicit Guard(std::atomic<uint64_t>* slot) : slot(slot) {}
+        std::atomic<uint64_t>* slot;  ///< Reader slot holding the pinned epoch
+    };
+
+    /**
+     * @brief Creates a manager with a fixed number of concurrent reader slots.
+     * @param maxReaders Number of readers that can be pinned at the same time.
+     */
+    explicit EpochManager(size_t maxReaders = 128);
+
+    /**
+     * @brief Frees everything that is still retired.
+     */
+    ~EpochManager();
+
+    /**
+     * @brief Pins the current epoch; shared pointers may be read while the guard lives.
+     * @return Guard that unpins the epoch when destroyed.
+     */
+    Guard pin();
+
+    /**
+     * @brief Defers freeing an object that readers may still reference.
+     * @param reclaim Callback that frees the object once no reader can see it.
+     */
+    void retire(std::function<void()> reclaim);
+
+    /**
+     * @brief Frees retired objects that are no longer visible to any reader.
+     * @return Number of objects freed.
+     */
+    size_t reclaim();
+
+    /**
+     * @brief Gets the number of retired objects waiting to be freed.
+     * @return Number of pending objects.
+     */
+    size_t pendingReclaims() const;
+
+private:
+    /**
+     * @brief Reader slot padded to its own cache line.
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};  ///< Pinned epoch, or 0 when free
+    };
+
+    std::atomic<uint64_t> globalEpoch;   ///< Current epoch
+    std::unique_ptr<Slot[]> slots;       ///< Reader slots
+    size_t slotCount;                    ///< Number of reader slots
+    mutable std::mutex retireLatch;      ///< Protects `retired`
+    std::vector<std::pair<uint64_t, std::function<void()>>> retired;  ///< Objects waiting to be freed
+};
+
+#endif // EPOCH_MANAGER_H
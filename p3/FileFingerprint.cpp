@@ -0,0 +1,46 @@
+#include "FileFingerprint.h"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Computes the fingerprint of the current version of a file.
+ *
+ * The content is hashed with 64-bit FNV-1a in 64 KiB chunks, far cheaper
+ * than parsing the file.
+ *
+ * @param path Path of the file.
+ * @param fingerprint Receives the fingerprint.
+ * @return True if the file could be read, false otherwise.
+ */
+bool fingerprintFile(const string& path, FileFingerprint& fingerprint) {
+    error_code error;
+    fingerprint.size = filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto written = filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    fingerprint.mtime = static_cast<long long>(written.time_since_epoch().count());
+
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    vector<char> chunk(1 << 16);
+    while (file.read(chunk.data(), chunk.size()) || file.gcount() > 0) {
+        streamsize count = file.gcount();
+        for (streamsize i = 0; i < count; i++) {
+            hash ^= static_cast<unsigned char>(chunk[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+    fingerprint.hash = hash;
+    return true;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file FileFingerprint.h
+ * @brief Identifies one version of a file by its size, modification time and content hash.
+ *
+ * A block file records the fingerprint of the CSV it was built from, so a
+ * later start can tell whether the block file and its index still describe
+ * the current CSV and skip rebuilding them.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef FILE_FINGERPRINT_H
+#define FILE_FINGERPRINT_H
+
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Size, modification time and FNV-1a hash of a file.
+ */
+struct FileFingerprint {
+    uint64_t size = 0;   ///< File size in bytes
+    long long mtime = 0; ///< Last write time in file clock ticks
+    uint64_t hash = 0;   ///< 64-bit FNV-1a hash of the content
+
+    bool operator==(const FileFingerprint& other) const {
+        return size == other.size && mtime == other.mtime && hash == other.hash;
+    }
+    bool operator!=(const FileFingerprint& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Computes the fingerprint of the current version of a file.
+ *
+ * @param path Path of the file.
+ * @param fingerprint Receives the fingerprint.
+ * @return True if the file could be read, false otherwise.
+ */
+bool fingerprintFile(const std::string& path, FileFingerprint& fingerprint);
+
+#endif // FILE_FINGERPRINT_H
@@ -0,0 +1,409 @@
+#include "GeoKernel.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEO_KERNEL_X86 1
+#endif
+
+using namespace std;
+
+/**
+ * @brief Degrees to radians factor.
+ */
+static const double RADIANS_PER_DEGREE = M_PI / 180.0;
+
+/**
+ * @brief Computes the haversine term a = sin²(Δlat/2) + cos(lat1) cos(lat2) sin²(Δlon/2) of one pair.
+ *
+ * @param latitude Latitude of the query point in radians.
+ * @param longitude Longitude of the query point in radians.
+ * @param cosLatitude Cosine of `latitude`.
+ * @param latitude2 Latitude of the other point in degrees.
+ * @param longitude2 Longitude of the other point in degrees.
+ * @return The haversine term, in [0, 1].
+ */
+static double haversineTerm(double latitude, double longitude, double cosLatitude, double latitude2, double longitude2) {
+    double latitude2Radians = latitude2 * RADIANS_PER_DEGREE;
+    double sinLatitude = sin((latitude2Radians - latitude) / 2);
+    double sinLongitude = sin((longitude2 * RADIANS_PER_DEGREE - longitude) / 2);
+    double a = sinLatitude * sinLatitude + cosLatitude * cos(latitude2Radians) * sinLongitude * sinLongitude;
+    return min(1.0, max(0.0, a));
+}
+
+/**
+ * @brief Gets the largest haversine term of a point within a radius.
+ *
+ * @param radiusKm Search radius in kilometers.
+ * @return sin²(d/2) for the angular radius d, or more than 1 if every point is within the radius.
+ */
+static double radiusTerm(double radiusKm) {
+    double angle = radiusKm / EARTH_RADIUS_KM;
+    if (angle >= M_PI) {
+        return 2.0;
+    }
+    double half = sin(angle / 2);
+    return half * half;
+}
+
+/**
+ * @brief Computes the great circle distance between two points.
+ *
+ * @param latitude1 Latitude of the first point in degrees.
+ * @param longitude1 Longitude of the first point in degrees.
+ * @param latitude2 Latitude of the second point in degrees.
+ * @param longitude2 Longitude of the second point in degrees.
+ * @return Distance in kilometers.
+ */
+double haversineKm(double latitude1, double longitude1, double latitude2, double longitude2) {
+    double latitude1Radians = latitude1 * RADIANS_PER_DEGREE;
+    double a = haversineTerm(latitude1Radians, longitude1 * RADIANS_PER_DEGREE, cos(latitude1Radians),
+                             latitude2, longitude2);
+    return 2 * EARTH_RADIUS_KM * asin(sqrt(a));
+}
+
+/**
+ * @brief Scalar batch distance kernel.
+ */
+static void haversineBatchScalar(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                                 size_t count, double* distancesKm) {
+    double latitudeRadians = latitude * RADIANS_PER_DEGREE;
+    double longitudeRadians = longitude * RADIANS_PER_DEGREE;
+    double cosLatitude = cos(latitudeRadians);
+    for (size_t i = 0; i < count; i++) {
+        double a = haversineTerm(latitudeRadians, longitudeRadians, cosLatitude, latitudes[i], longitudes[i]);
+        distancesKm[i] = 2 * EARTH_RADIUS_KM * asin(sqrt(a));
+    }
+}
+
+/**
+ * @brief Scalar radius filter kernel.
+ */
+static size_t radiusFilterScalar(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                                 size_t count, double radiusKm, uint32_t* hits) {
+    double latitudeRadians = latitude * RADIANS_PER_DEGREE;
+    double longitudeRadians = longitude * RADIANS_PER_DEGREE;
+    double cosLatitude = cos(latitudeRadians);
+    double limit = radiusTerm(radiusKm);
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (haversineTerm(latitudeRadians, longitudeRadians, cosLatitude, latitudes[i], longitudes[i]) <= limit) {
+            hits[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+#ifdef GEO_KERNEL_X86
+
+/**
+ * @brief Gets 1/n! at compile time.
+ *
+ * @param n Non-negative integer.
+ * @return The reciprocal of n factorial.
+ */
+static constexpr double inverseFactorial(int n) {
+    double factorial = 1.0;
+    for (int i = 2; i <= n; i++) {
+        factorial *= i;
+    }
+    return 1.0 / factorial;
+}
+
+/**
+ * @brief Taylor coefficients of sin(x) / x in powers of x²; exact to double precision on [-π/2, π/2].
+ */
+static constexpr double SIN_COEFFICIENTS[] = {
+    inverseFactorial(1),   -inverseFactorial(3),  inverseFactorial(5),  -inverseFactorial(7),
+    inverseFactorial(9),   -inverseFactorial(11), inverseFactorial(13), -inverseFactorial(15),
+    inverseFactorial(17),  -inverseFactorial(19)
+};
+
+/**
+ * @brief Taylor coefficients of cos(x) in powers of x²; exact to double precision on [-π/2, π/2].
+ */
+static constexpr double COS_COEFFICIENTS[] = {
+    inverseFactorial(0),   -inverseFactorial(2),  inverseFactorial(4),  -inverseFactorial(6),
+    inverseFactorial(8),   -inverseFactorial(10), inverseFactorial(12), -inverseFactorial(14),
+    inverseFactorial(16),  -inverseFactorial(18), inverseFactorial(20)
+};
+
+/**
+ * @brief Gets the Taylor coefficient of x^(2k+1) in asin(x), (2k)! / (4^k (k!)² (2k + 1)).
+ *
+ * @param k Term number.
+ * @return The coefficient.
+ */
+static constexpr double asinCoefficient(int k) {
+    double binomial = 1.0;  // (2k)! / (4^k (k!)²)
+    for (int i = 1; i <= k; i++) {
+        binomial *= (2.0 * i - 1) / (2.0 * i);
+    }
+    return binomial / (2 * k + 1);
+}
+
+/**
+ * @brief Taylor coefficients of asin(x) / x in powers of x²; exact to double precision for |x| <= sin(π/8).
+ */
+static constexpr double ASIN_COEFFICIENTS[] = {
+    asinCoefficient(0),  asinCoefficient(1),  asinCoefficient(2),  asinCoefficient(3),
+    asinCoefficient(4),  asinCoefficient(5),  asinCoefficient(6),  asinCoefficient(7),
+    asinCoefficient(8),  asinCoefficient(9),  asinCoefficient(10), asinCoefficient(11),
+    asinCoefficient(12), asinCoefficient(13), asinCoefficient(14), asinCoefficient(15)
+};
+
+/**
+ * @brief Evaluates a polynomial in x² by Horner's rule.
+ *
+ * @param coefficients Coefficients from the constant term up.
+ * @param count Number of coefficients.
+ * @param x2 Square of the variable.
+ * @return The polynomial value in every lane.
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d polynomialAVX2(const double* coefficients, int count, __m256d x2) {
+    __m256d result = _mm256_set1_pd(coefficients[count - 1]);
+    for (int i = count - 2; i >= 0; i--) {
+        result = _mm256_fmadd_pd(result, x2, _mm256_set1_pd(coefficients[i]));
+    }
+    return result;
+}
+
+/**
+ * @brief Computes |sin(x)| in every lane.
+ *
+ * x is reduced to [0, π] and then folded onto [0, π/2] with sin(x) = sin(π - x),
+ * where the Taylor series is exact to double precision.
+ *
+ * @param x Angles in radians.
+ * @return |sin(x)|, which is all the haversine term needs.
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d absSinAVX2(__m256d x) {
+    const __m256d twoPi = _mm256_set1_pd(2 * M_PI);
+    const __m256d pi = _mm256_set1_pd(M_PI);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d turns = _mm256_round_pd(_mm256_div_pd(x, twoPi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm256_andnot_pd(signMask, _mm256_fnmadd_pd(turns, twoPi, x));
+    x = _mm256_min_pd(x, _mm256_sub_pd(pi, x));
+    __m256d x2 = _mm256_mul_pd(x, x);
+    return _mm256_mul_pd(x, polynomialAVX2(SIN_COEFFICIENTS, 10, x2));
+}
+
+/**
+ * @brief Computes cos(x) in every lane for x in [-π/2, π/2].
+ *
+ * @param x Angles in radians.
+ * @return cos(x).
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d cosAVX2(__m256d x) {
+    return polynomialAVX2(COS_COEFFICIENTS, 11, _mm256_mul_pd(x, x));
+}
+
+/**
+ * @brief Computes 2 asin(sqrt(a)), the central angle of a haversine term, in every lane.
+ *
+ * The half-angle identity sin(φ/2) = sin(φ) / sqrt(2 (1 + cos(φ))) is applied
+ * twice so the Taylor series only sees arguments up to sin(π/8).
+ *
+ * @param a Haversine terms in [0, 1].
+ * @return Central angles in radians.
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d centralAngleAVX2(__m256d a) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    __m256d sine = _mm256_sqrt_pd(a);
+    __m256d square = a;
+    for (int halving = 0; halving < 2; halving++) {
+        __m256d cosine = _mm256_sqrt_pd(_mm256_sub_pd(one, square));
+        sine = _mm256_div_pd(sine, _mm256_sqrt_pd(_mm256_mul_pd(two, _mm256_add_pd(one, cosine))));
+        square = _mm256_mul_pd(sine, sine);
+    }
+    __m256d angle = _mm256_mul_pd(sine, polynomialAVX2(ASIN_COEFFICIENTS, 16, square));
+    return _mm256_mul_pd(_mm256_set1_pd(8.0), angle);
+}
+
+/**
+ * @brief Computes the haversine terms of four points.
+ *
+ * @param latitude Latitude of the query point in radians, in every lane.
+ * @param longitude Longitude of the query point in radians, in every lane.
+ * @param cosLatitude Cosine of the query latitude, in every lane.
+ * @param latitudes Latitudes of four points in degrees.
+ * @param longitudes Longitudes of four points in degrees.
+ * @return The haversine terms, clamped to [0, 1].
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d haversineTermAVX2(__m256d latitude, __m256d longitude, __m256d cosLatitude,
+                                        const double* latitudes, const double* longitudes) {
+    const __m256d toRadians = _mm256_set1_pd(RADIANS_PER_DEGREE);
+    const __m256d half = _mm256_set1_pd(0.5);
+    __m256d latitude2 = _mm256_mul_pd(_mm256_loadu_pd(latitudes), toRadians);
+    __m256d longitude2 = _mm256_mul_pd(_mm256_loadu_pd(longitudes), toRadians);
+    __m256d sinLatitude = absSinAVX2(_mm256_mul_pd(_mm256_sub_pd(latitude2, latitude), half));
+    __m256d sinLongitude = absSinAVX2(_mm256_mul_pd(_mm256_sub_pd(longitude2, longitude), half));
+    __m256d weight = _mm256_mul_pd(cosLatitude, cosAVX2(latitude2));
+    __m256d a = _mm256_fmadd_pd(_mm256_mul_pd(weight, sinLongitude), sinLongitude,
+                                _mm256_mul_pd(sinLatitude, sinLatitude));
+    return _mm256_min_pd(_mm256_set1_pd(1.0), _mm256_max_pd(_mm256_setzero_pd(), a));
+}
+
+/**
+ * @brief AVX2 batch distance kernel; the last count % 4 points use the scalar kernel.
+ */
+__attribute__((target("avx2,fma")))
+static void haversineBatchAVX2(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                               size_t count, double* distancesKm) {
+    double latitudeRadians = latitude * RADIANS_PER_DEGREE;
+    __m256d queryLatitude = _mm256_set1_pd(latitudeRadians);
+    __m256d queryLongitude = _mm256_set1_pd(longitude * RADIANS_PER_DEGREE);
+    __m256d cosLatitude = _mm256_set1_pd(cos(latitudeRadians));
+    __m256d radius = _mm256_set1_pd(EARTH_RADIUS_KM);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d a = haversineTermAVX2(queryLatitude, queryLongitude, cosLatitude, latitudes + i, longitudes + i);
+        _mm256_storeu_pd(distancesKm + i, _mm256_mul_pd(radius, centralAngleAVX2(a)));
+    }
+    haversineBatchScalar(latitude, longitude, latitudes + i, longitudes + i, count - i, distancesKm + i);
+}
+
+/**
+ * @brief AVX2 radius filter kernel; the last count % 4 points use the scalar kernel.
+ */
+__attribute__((target("avx2,fma")))
+static size_t radiusFilterAVX2(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                               size_t count, double radiusKm, uint32_t* hits) {
+    double latitudeRadians = latitude * RADIANS_PER_DEGREE;
+    __m256d queryLatitude = _mm256_set1_pd(latitudeRadians);
+    __m256d queryLongitude = _mm256_set1_pd(longitude * RADIANS_PER_DEGREE);
+    __m256d cosLatitude = _mm256_set1_pd(cos(latitudeRadians));
+    __m256d limit = _mm256_set1_pd(radiusTerm(radiusKm));
+
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d a = haversineTermAVX2(queryLatitude, queryLongitude, cosLatitude, latitudes + i, longitudes + i);
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(a, limit, _CMP_LE_OQ));
+        while (mask != 0) {
+            hits[found++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    size_t tail = radiusFilterScalar(latitude, longitude, latitudes + i, longitudes + i, count - i, radiusKm,
+                                     hits + found);
+    for (size_t j = found; j < found + tail; j++) {
+        hits[j] += static_cast<uint32_t>(i);
+    }
+    return found + tail;
+}
+
+#endif // GEO_KERNEL_X86
+
+/**
+ * @brief Checks whether the processor can run the AVX2 kernels.
+ *
+ * @return True if AVX2 and FMA are available.
+ */
+static bool avx2Supported() {
+#ifdef GEO_KERNEL_X86
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Gets the active kernel path; the first call picks the fastest supported one.
+ *
+ * @return Reference to the active path.
+ */
+static GeoKernelPath& activePath() {
+    static GeoKernelPath path = avx2Supported() ? GeoKernelPath::AVX2 : GeoKernelPath::Scalar;
+    return path;
+}
+
+/**
+ * @brief Computes the distance from one point to every point of an array.
+ *
+ * @param latitude Latitude of the query point in degrees.
+ * @param longitude Longitude of the query point in degrees.
+ * @param latitudes Latitudes of the points in degrees, within [-90, 90].
+ * @param longitudes Longitudes of the points in degrees.
+ * @param count Number of points.
+ * @param distancesKm Receives `count` distances in kilometers.
+ */
+void haversineBatchKm(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                      size_t count, double* distancesKm) {
+#ifdef GEO_KERNEL_X86
+    if (activePath() == GeoKernelPath::AVX2) {
+        haversineBatchAVX2(latitude, longitude, latitudes, longitudes, count, distancesKm);
+        return;
+    }
+#endif
+    haversineBatchScalar(latitude, longitude, latitudes, longitudes, count, distancesKm);
+}
+
+/**
+ * @brief Finds the points of an array within a distance of one point.
+ *
+ * Points are compared on the haversine term against sin²(d/2), so no arcsine is
+ * evaluated.
+ *
+ * @param latitude Latitude of the query point in degrees.
+ * @param longitude Longitude of the query point in degrees.
+ * @param latitudes Latitudes of the points in degrees, within [-90, 90].
+ * @param longitudes Longitudes of the points in degrees.
+ * @param count Number of points.
+ * @param radiusKm Search radius in kilometers.
+ * @param hits Receives the positions of the points within the radius; room for `count` entries.
+ * @return Number of positions written to `hits`.
+ */
+size_t radiusFilter(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                    size_t count, double radiusKm, uint32_t* hits) {
+    if (radiusKm < 0) {
+        return 0;
+    }
+#ifdef GEO_KERNEL_X86
+    if (activePath() == GeoKernelPath::AVX2) {
+        return radiusFilterAVX2(latitude, longitude, latitudes, longitudes, count, radiusKm, hits);
+    }
+#endif
+    return radiusFilterScalar(latitude, longitude, latitudes, longitudes, count, radiusKm, hits);
+}
+
+/**
+ * @brief Gets the implementation the batch kernels use.
+ *
+ * @return The active path.
+ */
+GeoKernelPath geoKernelPath() {
+    return activePath();
+}
+
+/**
+ * @brief Selects the implementation of the batch kernels; meant for benchmarks and tests.
+ *
+ * @param path Path to use.
+ * @return True if the path is supported on this processor, false otherwise.
+ */
+bool setGeoKernelPath(GeoKernelPath path) {
+    if (path == GeoKernelPath::AVX2 && !avx2Supported()) {
+        return false;
+    }
+    activePath() = path;
+    return true;
+}
+
+/**
+ * @brief Gets the name of a kernel path.
+ *
+ * @param path Path to name.
+ * @return "scalar" or "avx2".
+ */
+string geoKernelName(GeoKernelPath path) {
+    return path == GeoKernelPath::AVX2 ? "avx2" : "scalar";
+}
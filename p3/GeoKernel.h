@@ -0,0 +1,90 @@
+/**
+ * @file GeoKernel.h
+ * @brief Declaration of the batch great circle distance kernels.
+ *
+ * The kernels measure one point against contiguous arrays of latitudes and
+ * longitudes, which is how `SpatialIndex` stores the records of a grid cell. An
+ * AVX2 version handles four points per instruction with polynomial sine, cosine
+ * and arcsine; it is picked at run time when the processor supports AVX2 and FMA,
+ * and the scalar version is used everywhere else.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef GEO_KERNEL_H
+#define GEO_KERNEL_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Mean radius of the earth in kilometers.
+ */
+const double EARTH_RADIUS_KM = 6371.0088;
+
+/**
+ * @brief Implementation used by the batch kernels.
+ */
+enum class GeoKernelPath {
+    Scalar,  ///< One point at a time with the standard library trigonometry
+    AVX2     ///< Four points at a time with AVX2 and FMA
+};
+
+/**
+ * @brief Computes the great circle distance between two points.
+ * @param latitude1 Latitude of the first point in degrees.
+ * @param longitude1 Longitude of the first point in degrees.
+ * @param latitude2 Latitude of the second point in degrees.
+ * @param longitude2 Longitude of the second point in degrees.
+ * @return Distance in kilometers.
+ */
+double haversineKm(double latitude1, double longitude1, double latitude2, double longitude2);
+
+/**
+ * @brief Computes the distance from one point to every point of an array.
+ * @param latitude Latitude of the query point in degrees.
+ * @param longitude Longitude of the query point in degrees.
+ * @param latitudes Latitudes of the points in degrees, within [-90, 90].
+ * @param longitudes Longitudes of the points in degrees.
+ * @param count Number of points.
+ * @param distancesKm Receives `count` distances in kilometers.
+ */
+void haversineBatchKm(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                      size_t count, double* distancesKm);
+
+/**
+ * @brief Finds the points of an array within a distance of one point.
+ * @param latitude Latitude of the query point in degrees.
+ * @param longitude Longitude of the query point in degrees.
+ * @param latitudes Latitudes of the points in degrees, within [-90, 90].
+ * @param longitudes Longitudes of the points in degrees.
+ * @param count Number of points.
+ * @param radiusKm Search radius in kilometers.
+ * @param hits Receives the positions of the points within the radius; room for `count` entries.
+ * @return Number of positions written to `hits`.
+ */
+size_t radiusFilter(double latitude, double longitude, const double* latitudes, const double* longitudes,
+                    size_t count, double radiusKm, uint32_t* hits);
+
+/**
+ * @brief Gets the implementation the batch kernels use.
+ * @return The active path.
+ */
+GeoKernelPath geoKernelPath();
+
+/**
+ * @brief Selects the implementation of the batch kernels; meant for benchmarks and tests.
+ * @param path Path to use.
+ * @return True if the path is supported on this processor, false otherwise.
+ */
+bool setGeoKernelPath(GeoKernelPath path);
+
+/**
+ * @brief Gets the name of a kernel path.
+ * @param path Path to name.
+ * @return "scalar" or "avx2".
+ */
+std::string geoKernelName(GeoKernelPath path);
+
+#endif // GEO_KERNEL_H
@@ -1,8 +1,132 @@
 #include "HeaderRecord.h"
+#include "Crc32c.h"
 #include <fstream>
-#include <sstream>
 #include <iostream>
-#include <iomanip>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Offsets of the values in the binary header; see the HeaderRecord class comment
+ */
+enum HeaderOffset : size_t {
+    MAGIC_AT = 0,
+    FORMAT_VERSION_AT = 8,
+    HEADER_SIZE_AT = 12,
+    CRC_AT = 16,
+    FLAGS_AT = 20,
+    CODEC_AT = 24,
+    LAYOUT_AT = 25,
+    FIELD_COUNT_AT = 26,
+    PRIMARY_KEY_AT = 28,
+    BLOCK_SIZE_AT = 32,
+    MIN_CAPACITY_AT = 36,
+    RECORD_COUNT_AT = 40,
+    BLOCK_COUNT_AT = 48,
+    ACTIVE_LIST_AT = 56,
+    AVAIL_LIST_AT = 60,
+    SOURCE_SIZE_AT = 64,
+    SOURCE_MTIME_AT = 72,
+    SOURCE_HASH_AT = 80,
+    STRUCTURE_TYPE_AT = 96,
+    VERSION_AT = 128,
+    INDEX_NAME_AT = 144,
+    INDEX_SCHEMA_AT = 208,
+    SOURCE_FILE_AT = 272,
+    FIELDS_AT = 512
+};
+
+static const char HEADER_MAGIC[8] = {'Z', 'I', 'P', 'B', 'S', 'S', '\r', '\n'};
+static const size_t FIELD_SLOT = 32;   ///< Bytes for a field name or a type schema
+static const uint32_t STALE_FLAG = 1;  ///< Bit of the flags word holding the stale flag
+
+/**
+ * @brief Stores an unsigned number as little endian bytes
+ * @param bytes Destination
+ * @param value Number to store
+ * @param width Number of bytes to store
+ */
+static void putNumber(char* bytes, uint64_t value, size_t width) {
+    for (size_t i = 0; i < width; i++) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Loads an unsigned number stored as little endian bytes
+ * @param bytes Source
+ * @param width Number of bytes to load
+ * @return The number
+ */
+static uint64_t getNumber(const char* bytes, size_t width) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; i++) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Stores a string in a NUL padded slot
+ * @param bytes Destination slot, already zeroed
+ * @param value String to store
+ * @param slot Size of the slot; the string must leave room for one NUL
+ * @return true if the string fits, false otherwise
+ */
+static bool putString(char* bytes, const std::string& value, size_t slot) {
+    if (value.size() >= slot) {
+        std::cerr << "Error: Header value too long for its " << slot << " byte slot: " << value << std::endl;
+        return false;
+    }
+    std::memcpy(bytes, value.data(), value.size());
+    return true;
+}
+
+/**
+ * @brief Loads a string from a NUL padded slot
+ * @param bytes Source slot
+ * @param slot Size of the slot
+ * @return The string, up to the first NUL
+ */
+static std::string getString(const char* bytes, size_t slot) {
+    return std::string(bytes, strnlen(bytes, slot));
+}
+
+/**
+ * @brief Computes the checksum of a header, skipping its checksum field
+ * @param bytes Header of HeaderRecord::HEADER_SIZE bytes
+ * @return The CRC-32C of the header with the checksum field taken as zero
+ */
+static uint32_t headerChecksum(const char* bytes) {
+    static const char zero[4] = {0, 0, 0, 0};
+    uint32_t crc = crc32c(0, bytes, CRC_AT);
+    crc = crc32c(crc, zero, sizeof(zero));
+    return crc32c(crc, bytes + CRC_AT + 4, HeaderRecord::HEADER_SIZE - CRC_AT - 4);
+}
+
+/**
+ * @brief Checks that a buffer holds an intact header of the current format
+ * @param bytes Header bytes
+ * @param length Number of bytes available
+ * @param source File name for error messages
+ * @return true if magic, version, size and checksum are all valid, false otherwise
+ */
+static bool checkHeader(const char* bytes, size_t length, const std::string& source) {
+    if (length < HeaderRecord::HEADER_SIZE || std::memcmp(bytes + MAGIC_AT, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0) {
+        std::cerr << "Error: Not a blocked sequence set file: " << source << std::endl;
+        return false;
+    }
+    if (getNumber(bytes + FORMAT_VERSION_AT, 4) != HeaderRecord::FORMAT_VERSION
+        || getNumber(bytes + HEADER_SIZE_AT, 4) != HeaderRecord::HEADER_SIZE) {
+        std::cerr << "Error: Unsupported header version in file: " << source << std::endl;
+        return false;
+    }
+    if (getNumber(bytes + CRC_AT, 4) != headerChecksum(bytes)) {
+        std::cerr << "Error: Header checksum mismatch, file is corrupted: " << source << std::endl;
+        return false;
+    }
+    return true;
+}
 
 /**
  * @brief Default constructor for HeaderRecord
@@ -10,12 +134,11 @@
  * Initializes all numeric members to sensible defaults
  */
 HeaderRecord::HeaderRecord()
-    : headerSize(0)
-    , recordSizeBytes(-1)
+    : headerSize(HEADER_SIZE)
     , blockSize(512)  // Default block size of 512 bytes
     , minBlockCapacity(0.5)  // Default 50% minimum capacity
-    , recordCount(40933) // Record count of input data
-    , blockCount(3679) 
+    , recordCount(0)  // Counted while the blocks are written
+    , blockCount(0)
     , fieldCount(6) // Default 6 as all used zipcode data has 6 peramiters
     , primaryKeyField(0)
     , availListRBN(-1)
@@ -23,7 +146,8 @@ HeaderRecord::HeaderRecord()
     , isStale(false) {
     fileStructureType = "blocked_sequence_set";
     version = "1.0";
-    sizeFormatType = "ASCII";
+    blockCodec = "none";
+    blockLayout = "zip";
 }
 
 /**
@@ -39,9 +163,92 @@ void HeaderRecord::addField(const std::string& name, const std::string& schema)
     fieldCount = fields.size();
 }
 
+/**
+ * @brief Lays the header out in its binary form
+ * @param bytes Destination of HEADER_SIZE bytes, checksum included
+ */
+void HeaderRecord::encode(char* bytes) const {
+    std::memset(bytes, 0, HEADER_SIZE);
+    std::memcpy(bytes + MAGIC_AT, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+    putNumber(bytes + FORMAT_VERSION_AT, FORMAT_VERSION, 4);
+    putNumber(bytes + HEADER_SIZE_AT, HEADER_SIZE, 4);
+    putNumber(bytes + FLAGS_AT, isStale ? STALE_FLAG : 0, 4);
+    putNumber(bytes + CODEC_AT, blockCodec == "dict" ? 1 : 0, 1);
+    putNumber(bytes + LAYOUT_AT, blockLayout == "hilbert" ? 1 : 0, 1);
+    putNumber(bytes + FIELD_COUNT_AT, fields.size() < MAX_FIELDS ? fields.size() : MAX_FIELDS, 2);
+    putNumber(bytes + PRIMARY_KEY_AT, static_cast<uint32_t>(primaryKeyField), 4);
+    putNumber(bytes + BLOCK_SIZE_AT, static_cast<uint32_t>(blockSize), 4);
+    putNumber(bytes + MIN_CAPACITY_AT, static_cast<uint32_t>(minBlockCapacity * 100), 4);
+    putNumber(bytes + RECORD_COUNT_AT, recordCount, 8);
+    putNumber(bytes + BLOCK_COUNT_AT, blockCount, 8);
+    putNumber(bytes + ACTIVE_LIST_AT, static_cast<uint32_t>(activeListRBN), 4);
+    putNumber(bytes + AVAIL_LIST_AT, static_cast<uint32_t>(availListRBN), 4);
+    putNumber(bytes + SOURCE_SIZE_AT, sourceFingerprint.size, 8);
+    putNumber(bytes + SOURCE_MTIME_AT, static_cast<uint64_t>(sourceFingerprint.mtime), 8);
+    putNumber(bytes + SOURCE_HASH_AT, sourceFingerprint.hash, 8);
+    putString(bytes + STRUCTURE_TYPE_AT, fileStructureType, VERSION_AT - STRUCTURE_TYPE_AT);
+    putString(bytes + VERSION_AT, version, INDEX_NAME_AT - VERSION_AT);
+    putString(bytes + INDEX_NAME_AT, indexFileName, INDEX_SCHEMA_AT - INDEX_NAME_AT);
+    putString(bytes + INDEX_SCHEMA_AT, indexFileSchema, SOURCE_FILE_AT - INDEX_SCHEMA_AT);
+    if (sourceFile.size() < FIELDS_AT - SOURCE_FILE_AT) {  // Longer names are left out; such files always rebuild
+        putString(bytes + SOURCE_FILE_AT, sourceFile, FIELDS_AT - SOURCE_FILE_AT);
+    }
+    for (size_t i = 0; i < fields.size() && i < MAX_FIELDS; i++) {
+        char* slot = bytes + FIELDS_AT + i * 2 * FIELD_SLOT;
+        putString(slot, fields[i].name, FIELD_SLOT);
+        putString(slot + FIELD_SLOT, fields[i].typeSchema, FIELD_SLOT);
+    }
+    putNumber(bytes + CRC_AT, headerChecksum(bytes), 4);
+}
+
+/**
+ * @brief Fills the header from its binary form
+ * @param bytes Header bytes, already checked by checkHeader
+ * @param length Number of bytes available
+ * @return true if successful, false otherwise
+ */
+bool HeaderRecord::decode(const char* bytes, size_t length) {
+    if (length < HEADER_SIZE) {
+        return false;
+    }
+    headerSize = getNumber(bytes + HEADER_SIZE_AT, 4);
+    isStale = (getNumber(bytes + FLAGS_AT, 4) & STALE_FLAG) != 0;
+    blockCodec = getNumber(bytes + CODEC_AT, 1) == 1 ? "dict" : "none";
+    blockLayout = getNumber(bytes + LAYOUT_AT, 1) == 1 ? "hilbert" : "zip";
+    fieldCount = static_cast<int>(getNumber(bytes + FIELD_COUNT_AT, 2));
+    primaryKeyField = static_cast<int32_t>(getNumber(bytes + PRIMARY_KEY_AT, 4));
+    blockSize = static_cast<int32_t>(getNumber(bytes + BLOCK_SIZE_AT, 4));
+    minBlockCapacity = static_cast<int32_t>(getNumber(bytes + MIN_CAPACITY_AT, 4)) / 100.0;
+    recordCount = getNumber(bytes + RECORD_COUNT_AT, 8);
+    blockCount = getNumber(bytes + BLOCK_COUNT_AT, 8);
+    activeListRBN = static_cast<int32_t>(getNumber(bytes + ACTIVE_LIST_AT, 4));
+    availListRBN = static_cast<int32_t>(getNumber(bytes + AVAIL_LIST_AT, 4));
+    sourceFingerprint.size = getNumber(bytes + SOURCE_SIZE_AT, 8);
+    sourceFingerprint.mtime = static_cast<long long>(getNumber(bytes + SOURCE_MTIME_AT, 8));
+    sourceFingerprint.hash = getNumber(bytes + SOURCE_HASH_AT, 8);
+    fileStructureType = getString(bytes + STRUCTURE_TYPE_AT, VERSION_AT - STRUCTURE_TYPE_AT);
+    version = getString(bytes + VERSION_AT, INDEX_NAME_AT - VERSION_AT);
+    indexFileName = getString(bytes + INDEX_NAME_AT, INDEX_SCHEMA_AT - INDEX_NAME_AT);
+    indexFileSchema = getString(bytes + INDEX_SCHEMA_AT, SOURCE_FILE_AT - INDEX_SCHEMA_AT);
+    sourceFile = getString(bytes + SOURCE_FILE_AT, FIELDS_AT - SOURCE_FILE_AT);
+    if (fieldCount < 0 || static_cast<size_t>(fieldCount) > MAX_FIELDS) {
+        std::cerr << "Error parsing header: invalid field count " << fieldCount << std::endl;
+        return false;
+    }
+    fields.clear();
+    for (int i = 0; i < fieldCount; i++) {
+        const char* slot = bytes + FIELDS_AT + i * 2 * FIELD_SLOT;
+        fields.push_back({getString(slot, FIELD_SLOT), getString(slot + FIELD_SLOT, FIELD_SLOT)});
+    }
+    return true;
+}
+
 /**
  * @brief Writes the header information to an already open file stream
  * 
+ * The header always takes HEADER_SIZE bytes, so it can be written again over
+ * the first one once the record and block counts are known.
+ * 
  * @param file Reference to an open output file stream
  * @return true if successful, false otherwise
  */
@@ -50,40 +257,27 @@ bool HeaderRecord::writeHeader(std::ofstream& file) {
         std::cerr << "Error: File stream is not open" << std::endl;
         return false;
     }
-
-    // Lambda to write length-indicated field
-    auto writeField = [&file](const std::string& value) {
-        std::string lengthStr = std::to_string(value.length());
-        if (lengthStr.length() < 2) lengthStr = "0" + lengthStr;
-        file << lengthStr << value << ",";
-    };
-
-    // Write main header fields
-    writeField(fileStructureType);
-    writeField(version);
-    writeField(std::to_string(headerSize));
-    writeField(std::to_string(recordSizeBytes));
-    writeField(sizeFormatType);
-    writeField(std::to_string(blockSize));
-    writeField(std::to_string(static_cast<int>(minBlockCapacity * 100)));
-    writeField(indexFileName);
-    writeField(indexFileSchema);
-    writeField(std::to_string(recordCount));
-    writeField(std::to_string(blockCount));
-    writeField(std::to_string(fieldCount));
-    writeField(std::to_string(primaryKeyField));
-    writeField(std::to_string(availListRBN));
-    writeField(std::to_string(activeListRBN));
-    file << (isStale ? "1" : "0") << "\n";
-
-    // Write field metadata
+    if (fields.size() > MAX_FIELDS) {
+        std::cerr << "Error: Header has room for " << MAX_FIELDS << " fields, not " << fields.size() << std::endl;
+        return false;
+    }
+    if (fileStructureType.size() >= VERSION_AT - STRUCTURE_TYPE_AT || version.size() >= INDEX_NAME_AT - VERSION_AT
+        || indexFileName.size() >= INDEX_SCHEMA_AT - INDEX_NAME_AT
+        || indexFileSchema.size() >= SOURCE_FILE_AT - INDEX_SCHEMA_AT) {
+        std::cerr << "Error: Header value too long for its slot" << std::endl;
+        return false;
+    }
     for (const auto& field : fields) {
-        writeField(field.name);
-        writeField(field.typeSchema);
-        file << "\n";
+        if (field.name.size() >= FIELD_SLOT || field.typeSchema.size() >= FIELD_SLOT) {
+            std::cerr << "Error: Field definition too long for its slot: " << field.name << std::endl;
+            return false;
+        }
     }
 
-    return true;
+    char bytes[HEADER_SIZE];
+    encode(bytes);
+    file.write(bytes, HEADER_SIZE);
+    return file.good();
 }
 
 /**
@@ -93,73 +287,81 @@ bool HeaderRecord::writeHeader(std::ofstream& file) {
  * @return true if successful, false otherwise
  */
 bool HeaderRecord::readHeader(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
         std::cerr << "Error: Unable to open file for reading: " << filename << std::endl;
         return false;
     }
 
-    std::string line;
-    if (std::getline(file, line)) {
-        std::stringstream ss(line);
-        
-        // Lambda to read length-indicated field
-        auto readField = [](std::stringstream& ss) -> std::string {
-            std::string lenStr;
-            lenStr.resize(2);
-            if (!ss.read(&lenStr[0], 2)) return "";
-            
-            if (!std::isdigit(lenStr[0]) || !std::isdigit(lenStr[1])) {
-                throw std::runtime_error("Invalid length indicator");
-            }
-            
-            int length = std::stoi(lenStr);
-            std::string value;
-            value.resize(length);
-            if (!ss.read(&value[0], length)) return "";
-            
-            if (ss.peek() == ',') ss.ignore();
-            return value;
-        };
-
-        try {
-            // Read main header fields
-            fileStructureType = readField(ss);
-            version = readField(ss);
-            headerSize = std::stoi(readField(ss));
-            recordSizeBytes = std::stoi(readField(ss));
-            sizeFormatType = readField(ss);
-            blockSize = std::stoi(readField(ss));
-            minBlockCapacity = std::stoi(readField(ss)) / 100.0;
-            indexFileName = readField(ss);
-            indexFileSchema = readField(ss);
-            recordCount = std::stoi(readField(ss));
-            blockCount = std::stoi(readField(ss));
-            fieldCount = std::stoi(readField(ss));
-            primaryKeyField = std::stoi(readField(ss));
-            availListRBN = std::stoi(readField(ss));
-            activeListRBN = std::stoi(readField(ss));
-            
-            std::string staleStr;
-            ss >> staleStr;
-            isStale = (staleStr == "1");
-
-            // Read field metadata
-            fields.clear();
-            for (int i = 0; i < fieldCount && std::getline(file, line); i++) {
-                std::stringstream fieldSS(line);
-                FieldMetadata metadata;
-                metadata.name = readField(fieldSS);
-                metadata.typeSchema = readField(fieldSS);
-                fields.push_back(metadata);
-            }
-        }
-        catch (const std::exception& e) {
-            std::cerr << "Error parsing header: " << e.what() << std::endl;
-            return false;
-        }
+    char bytes[HEADER_SIZE];
+    ssize_t count = ::pread(fd, bytes, HEADER_SIZE, 0);
+    ::close(fd);
+    size_t length = count > 0 ? static_cast<size_t>(count) : 0;
+    return checkHeader(bytes, length, filename) && decode(bytes, length);
+}
+
+/**
+ * @brief Reads and checks header information from an open file descriptor with a single pread
+ * 
+ * @param fd File descriptor of the file to read from
+ * @return true if successful, false otherwise
+ */
+bool HeaderRecord::readHeader(int fd) {
+    char bytes[HEADER_SIZE];
+    ssize_t count = ::pread(fd, bytes, HEADER_SIZE, 0);
+    size_t length = count > 0 ? static_cast<size_t>(count) : 0;
+    return checkHeader(bytes, length, "fd " + std::to_string(fd)) && decode(bytes, length);
+}
+
+/**
+ * @brief Reads and parses header information from an already open stream
+ * 
+ * On success the stream is left positioned just after the header, i.e. at
+ * the first block of a blocked sequence set file.
+ * 
+ * @param file Reference to an open input file stream
+ * @return true if successful, false otherwise
+ */
+bool HeaderRecord::readHeader(std::ifstream& file) {
+    if (!file.is_open()) {
+        std::cerr << "Error: File stream is not open" << std::endl;
+        return false;
     }
 
-    file.close();
-    return true;
-}
\ No newline at end of file
+    char bytes[HEADER_SIZE];
+    file.read(bytes, HEADER_SIZE);
+    size_t length = static_cast<size_t>(file.gcount());
+    return checkHeader(bytes, length, "input stream") && decode(bytes, length);
+}
+
+/**
+ * @brief Rewrites the stale flag of an existing header in place
+ * 
+ * The flag lives in the flags word of the header, so only the header is
+ * rewritten, with its checksum updated; the blocks are not touched.
+ * 
+ * @param filename Name of the file whose header is updated
+ * @return true if successful, false otherwise
+ */
+bool HeaderRecord::writeStaleFlag(const std::string& filename) const {
+    int fd = ::open(filename.c_str(), O_RDWR);
+    if (fd == -1) {
+        std::cerr << "Error: Unable to open file for update: " << filename << std::endl;
+        return false;
+    }
+
+    char bytes[HEADER_SIZE];
+    ssize_t count = ::pread(fd, bytes, HEADER_SIZE, 0);
+    if (!checkHeader(bytes, count > 0 ? static_cast<size_t>(count) : 0, filename)) {
+        ::close(fd);
+        return false;
+    }
+
+    uint32_t flags = static_cast<uint32_t>(getNumber(bytes + FLAGS_AT, 4));
+    flags = isStale ? (flags | STALE_FLAG) : (flags & ~STALE_FLAG);
+    putNumber(bytes + FLAGS_AT, flags, 4);
+    putNumber(bytes + CRC_AT, headerChecksum(bytes), 4);
+    bool written = ::pwrite(fd, bytes, HEADER_SIZE, 0) == static_cast<ssize_t>(HEADER_SIZE);
+    ::close(fd);
+    return written;
+}
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include "FileFingerprint.h"
 
 /**
  * @brief Metadata structure for field information in the header
@@ -18,14 +20,49 @@ struct FieldMetadata {
  * 
  * This class handles reading and writing header records that contain metadata
  * about the file structure, block organization, and field definitions.
+ * 
+ * The header is a fixed size binary record at the start of the file, so it is
+ * read with one call and every value sits at a known offset. Numbers are
+ * little endian and strings are NUL padded to the size of their slot:
+ * 
+ *     offset size  value
+ *          0    8  magic "ZIPBSS\r\n"
+ *          8    4  format version (FORMAT_VERSION)
+ *         12    4  header size in bytes, the offset of the first block
+ *         16    4  CRC-32C of the whole header, computed with this field zero
+ *         20    4  flags, bit 0 is the stale flag
+ *         24    1  block codec (0 none, 1 dict)
+ *         25    1  block layout (0 zip, 1 hilbert)
+ *         26    2  number of fields per record
+ *         28    4  ordinal of the primary key field
+ *         32    4  block size in bytes
+ *         36    4  minimum block capacity in percent
+ *         40    8  number of records
+ *         48    8  number of blocks
+ *         56    4  index root RBN, the head of the active list
+ *         60    4  head of the avail list
+ *         64   24  size, modification time and hash of the source CSV
+ *         96   32  file structure type
+ *        128   16  version of the file structure
+ *        144   64  index file name
+ *        208   64  index file schema
+ *        272  240  source CSV file name, empty if unknown
+ *        512  512  up to MAX_FIELDS field names and type schemas, 32 bytes each
+ * 
+ * A header with the wrong magic, version, size or checksum is rejected before
+ * any block is read.
  */
 class HeaderRecord {
 public:
+    static const uint32_t FORMAT_VERSION = 2;  ///< Version of the binary header layout
+    static const size_t HEADER_SIZE = 1024;    ///< Size of the header record in bytes
+    static const size_t MAX_FIELDS = 8;        ///< Number of field definitions the header has room for
+
     HeaderRecord();
     
     /**
      * @brief Writes the header information to a file
-     * @param file ofstream of the file to write to
+     * @param file ofstream of the file to write to, positioned at the start of the file
      * @return true if successful, false otherwise
      */
     bool writeHeader(std::ofstream& file);
@@ -36,6 +73,27 @@ public:
      * @return true if successful, false otherwise
      */
     bool readHeader(const std::string& filename);
+
+    /**
+     * @brief Reads and parses header information from an already open stream
+     * @param file ifstream positioned at the start of the file; left at the first block
+     * @return true if successful, false otherwise
+     */
+    bool readHeader(std::ifstream& file);
+
+    /**
+     * @brief Reads and checks header information from an open file descriptor with a single pread
+     * @param fd File descriptor of the file to read from
+     * @return true if successful, false otherwise
+     */
+    bool readHeader(int fd);
+
+    /**
+     * @brief Rewrites the stale flag of an existing header in place
+     * @param filename Name of the file whose header is updated
+     * @return true if successful, false otherwise
+     */
+    bool writeStaleFlag(const std::string& filename) const;
     
     // Setters
     void setFileStructureType(const std::string& type) { fileStructureType = type; }
@@ -48,11 +106,19 @@ public:
     void setAvailListRBN(int rbn) { availListRBN = rbn; }
     void setActiveListRBN(int rbn) { activeListRBN = rbn; }
     void setStaleFlag(bool flag) { isStale = flag; }
+    void setBlockCodec(const std::string& codec) { blockCodec = codec; }
+    void setBlockLayout(const std::string& layout) { blockLayout = layout; }
+    void setSource(const std::string& file, const FileFingerprint& fingerprint) { sourceFile = file; sourceFingerprint = fingerprint; }
+    void setRecordCount(uint64_t count) { recordCount = count; }
+    void setBlockCount(uint64_t count) { blockCount = count; }
     void addField(const std::string& name, const std::string& schema);
     
     // Getters
     std::string getFileStructureType() const { return fileStructureType; }
     std::string getVersion() const { return version; }
+    size_t getHeaderSize() const { return headerSize; }
+    uint64_t getRecordCount() const { return recordCount; }
+    uint64_t getBlockCount() const { return blockCount; }
     int getBlockSize() const { return blockSize; }
     double getMinBlockCapacity() const { return minBlockCapacity; }
     std::string getIndexFileName() const { return indexFileName; }
@@ -61,26 +127,35 @@ public:
     int getAvailListRBN() const { return availListRBN; }
     int getActiveListRBN() const { return activeListRBN; }
     bool getStaleFlag() const { return isStale; }
+    std::string getBlockCodec() const { return blockCodec; }
+    std::string getBlockLayout() const { return blockLayout; }
+    std::string getSourceFile() const { return sourceFile; }
+    const FileFingerprint& getSourceFingerprint() const { return sourceFingerprint; }
     const std::vector<FieldMetadata>& getFields() const { return fields; }
     
 private:
     std::string fileStructureType;     ///< Type of file structure
     std::string version;               ///< Version of the file structure
-    int headerSize;                    ///< Size of the header record in bytes
-    int recordSizeBytes;               ///< Number of bytes for record size integers
-    std::string sizeFormatType;        ///< Format type for sizes (ASCII/binary)
+    size_t headerSize;                 ///< Size of the header record in bytes
     int blockSize;                     ///< Size of each block in bytes
     double minBlockCapacity;           ///< Minimum block capacity (default 50%)
     std::string indexFileName;         ///< Name of the index file
     std::string indexFileSchema;       ///< Schema information for the index file
-    int recordCount;                   ///< Total number of records
-    int blockCount;                    ///< Total number of blocks
+    uint64_t recordCount;              ///< Total number of records
+    uint64_t blockCount;               ///< Total number of blocks
     int fieldCount;                    ///< Number of fields per record
     std::vector<FieldMetadata> fields; ///< Metadata for each field
     int primaryKeyField;               ///< Ordinal number of primary key field
     int availListRBN;                  ///< RBN link to block avail-list
     int activeListRBN;                 ///< RBN link to active sequence set list
+    std::string blockCodec;            ///< Codec used for new block payloads (none/dict)
+    std::string blockLayout;           ///< Order records were bulk loaded in (zip/hilbert)
+    std::string sourceFile;            ///< CSV file the blocks were built from, empty if unknown
+    FileFingerprint sourceFingerprint; ///< Version of the CSV file the blocks were built from
     bool isStale;                      ///< Stale flag for header
+
+    void encode(char* bytes) const;
+    bool decode(const char* bytes, size_t length);
 };
 
 #endif // HEADER_RECORD_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "HilbertCurve.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Maps a coordinate onto an integer grid axis.
+ *
+ * @param value Coordinate to map.
+ * @param low Smallest coordinate.
+ * @param high Largest coordinate.
+ * @param cells Number of cells along the axis.
+ * @return Cell number in [0, cells).
+ */
+static uint64_t gridCell(double value, double low, double high, uint64_t cells) {
+    double fraction = (min(max(value, low), high) - low) / (high - low);
+    uint64_t cell = static_cast<uint64_t>(fraction * static_cast<double>(cells));
+    return min(cell, cells - 1);
+}
+
+/**
+ * @brief Gets the position of a point along a Hilbert curve over the globe.
+ *
+ * Uses the classic iterative conversion from grid coordinates to curve
+ * distance: each level picks the quadrant and rotates the remaining square so
+ * the sub-curve enters and leaves next to its neighbours.
+ *
+ * @param latitude Latitude in degrees; clamped to [-90, 90].
+ * @param longitude Longitude in degrees; clamped to [-180, 180].
+ * @param order Bits per coordinate; the curve visits a 2^order by 2^order grid (at most 31).
+ * @return Distance of the point's grid cell along the curve.
+ */
+uint64_t hilbertIndex(double latitude, double longitude, int order) {
+    order = min(max(order, 1), 31);
+    uint64_t side = 1ULL << order;
+    uint64_t x = gridCell(longitude, -180.0, 180.0, side);
+    uint64_t y = gridCell(latitude, -90.0, 90.0, side);
+
+    uint64_t distance = 0;
+    for (uint64_t half = side / 2; half > 0; half /= 2) {
+        uint64_t rx = (x & half) ? 1 : 0;
+        uint64_t ry = (y & half) ? 1 : 0;
+        distance += half * half * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return distance;
+}
@@ -0,0 +1,26 @@
+/**
+ * @file HilbertCurve.h
+ * @brief Declaration of the Hilbert curve index of a latitude/longitude point.
+ *
+ * Points that are close on the globe are mostly close on the Hilbert curve, so
+ * sorting records by their Hilbert index places neighbouring zip codes in the
+ * same or adjacent blocks.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef HILBERT_CURVE_H
+#define HILBERT_CURVE_H
+
+#include <cstdint>
+
+/**
+ * @brief Gets the position of a point along a Hilbert curve over the globe.
+ * @param latitude Latitude in degrees; clamped to [-90, 90].
+ * @param longitude Longitude in degrees; clamped to [-180, 180].
+ * @param order Bits per coordinate; the curve visits a 2^order by 2^order grid (at most 31).
+ * @return Distance of the point's grid cell along the curve.
+ */
+uint64_t hilbertIndex(double latitude, double longitude, int order = 16);
+
+#endif // HILBERT_CURVE_H
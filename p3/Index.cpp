@@ -1,8 +1,15 @@
 #include "Index.h"
+#include "HeaderRecord.h"
+#include "BlockCodec.h"
+#include "BloomFilter.h"
+#include "StateIndex.h"
+#include "CityIndex.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
 #include <vector>
+#include <algorithm>
 
 using namespace std;
 
@@ -28,7 +35,12 @@ vector<string> Index::split( const string& line, char delimiter ) {
  *
  * This method reads data from an input file, extracts and processes relevant information,
  * and writes the results into an output file. Each valid block and zip code pair is stored
- * in the output file in the format "Block,Zip Code".
+ * in the output file in the format "Block,Zip Code", sorted by zip code whatever the
+ * block layout. A Bloom filter over every zip code is saved next to the output file
+ * as `<outputFileName>.bloom`, and the latitude/longitude bounds of every block as
+ * `<outputFileName>.bounds`, one "RBN minLat minLon maxLat maxLon" line per block.
+ * The state and city secondary indexes are saved as `<outputFileName>.state` and
+ * `<outputFileName>.city`.
  *
  * @param inputFileName The name of the input file containing block data.
  * @param outputFileName The name of the output file where processed data will be saved.
@@ -47,9 +59,18 @@ void Index::processBlockData( const string& inputFileName, const string& outputF
   }
 
   outputFile << "Block,Zip Code\n";
+  HeaderRecord header;
+  if ( !header.readHeader( inputFile ) ) {
+    cerr << "Error: Could not read header of " << inputFileName << endl;
+    return;
+  }
   string line;
-  getline( inputFile, line );
-  line = "";
+  vector<int> zips; // Every zip code, for the Bloom filter
+  vector<pair<int, string>> entries; // Zip code and block of every record
+  StateIndex states; // Zip codes and blocks of every state
+  CityIndex cities; // Zip codes and blocks of every city name
+  ofstream boundsFile( outputFileName + ".bounds" );
+  boundsFile.precision( 10 );
   while ( getline( inputFile, line ) ) {
     if ( line.empty() ) continue;
 
@@ -65,24 +86,54 @@ void Index::processBlockData( const string& inputFileName, const string& outputF
     }
     else {
       // Process lines with valid block:data format
-      string block = line.substr( 0, colonPos ); // Block number
+      string block = line.substr( 0, min( colonPos, line.find( '#' ) ) ); // Block number, without its checksum
       string data = line.substr( colonPos + 1 ); // Rest of the data
 
-      // Split data into fields
-      vector<string> fields = split( data, ',' );
+      // Decode the block payload into its fields
+      vector<string> fields = decodeBlockPayload( data );
 
       // Extract zip codes (skip 5 fields for each)
-      for ( size_t i = 0; i < fields.size(); i += 6 ) {
+      double minLat = 90, minLon = 180, maxLat = -90, maxLon = -180;
+      for ( size_t i = 0; i + 5 < fields.size(); i += 6 ) {
         if ( !fields[ i ].empty() && isdigit( fields[ i ][ 0 ] ) ) {
           string zipCode = fields[ i ];
-          outputFile << zipCode << " " << block << "\n";
+          entries.emplace_back( atoi( zipCode.c_str() ), block );
+          states.add( fields[ i + 2 ], atoi( zipCode.c_str() ), atoi( block.c_str() ) );
+          cities.add( fields[ i + 1 ], fields[ i + 2 ], atoi( zipCode.c_str() ), atoi( block.c_str() ) );
+          zips.push_back( atoi( zipCode.c_str() ) );
         }
+        double lat = atof( fields[ i + 4 ].c_str() );
+        double lon = atof( fields[ i + 5 ].c_str() );
+        minLat = min( minLat, lat );
+        maxLat = max( maxLat, lat );
+        minLon = min( minLon, lon );
+        maxLon = max( maxLon, lon );
+      }
+      if ( !fields.empty() ) {
+        boundsFile << block << " " << minLat << " " << minLon << " " << maxLat << " " << maxLon << "\n";
       }
     }
   }
 
+  // Blocks laid out along a space filling curve hold scattered zip codes
+  stable_sort( entries.begin(), entries.end(),
+               []( const pair<int, string>& a, const pair<int, string>& b ) { return a.first < b.first; } );
+  for ( const auto& entry : entries ) {
+    outputFile << entry.first << " " << entry.second << "\n";
+  }
+
   inputFile.close();
   outputFile.close();
+  boundsFile.close();
+
+  BloomFilter filter;
+  filter.reset( zips.size() );
+  for ( int zip : zips ) {
+    filter.add( zip );
+  }
+  filter.save( outputFileName + ".bloom" );
+  states.save( outputFileName + ".state" );
+  cities.save( outputFileName + ".city" );
 
   cout << "Data successfully organized and saved to '" << outputFileName << "'.\n";
 }
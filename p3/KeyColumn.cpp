@@ -0,0 +1,157 @@
+#include "KeyColumn.h"
+
+using namespace std;
+
+/**
+ * @brief Constructs an empty key column.
+ */
+KeyColumn::KeyColumn() : count(0), interval(16), sorted(true) {}
+
+/**
+ * @brief Appends a signed value as a zigzag encoded varint.
+ *
+ * @param out Buffer to append to.
+ * @param value Value to encode.
+ */
+void KeyColumn::putVarint(vector<uint8_t>& out, int64_t value) {
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    while (zigzag >= 0x80) {
+        out.push_back(static_cast<uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(zigzag));
+}
+
+/**
+ * @brief Reads a zigzag encoded varint and advances the cursor past it.
+ *
+ * @param cursor Position of the varint.
+ * @return The decoded value.
+ */
+int64_t KeyColumn::getVarint(const uint8_t*& cursor) {
+    uint64_t zigzag = 0;
+    int shift = 0;
+    while (*cursor & 0x80) {
+        zigzag |= static_cast<uint64_t>(*cursor++ & 0x7f) << shift;
+        shift += 7;
+    }
+    zigzag |= static_cast<uint64_t>(*cursor++) << shift;
+    return static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+}
+
+/**
+ * @brief Encodes the keys of a block.
+ *
+ * @param keys Keys in record order; binary search is used when they are ascending.
+ * @param restartInterval Number of keys between two restart points.
+ */
+void KeyColumn::build(const vector<int>& keys, size_t restartInterval) {
+    bytes.clear();
+    restarts.clear();
+    count = keys.size();
+    interval = restartInterval == 0 ? 1 : restartInterval;
+    sorted = true;
+    // Zip code deltas take one to three bytes; reserving once avoids regrowing per key
+    bytes.reserve(keys.size() * 3);
+    restarts.reserve(keys.size() / interval + 1);
+
+    int64_t previous = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (i > 0 && keys[i] < keys[i - 1]) {
+            sorted = false;
+        }
+        if (i % interval == 0) {
+            restarts.push_back(static_cast<uint32_t>(bytes.size()));
+            putVarint(bytes, keys[i]);
+        } else {
+            putVarint(bytes, keys[i] - previous);
+        }
+        previous = keys[i];
+    }
+}
+
+/**
+ * @brief Finds the ordinal of a key.
+ *
+ * Sorted columns binary search the restart points and scan one run of deltas;
+ * unsorted columns are scanned in full.
+ *
+ * @param key Key to look for.
+ * @return Position of the key in record order, or -1 if it is not in the column.
+ */
+int KeyColumn::find(int key) const {
+    if (count == 0) {
+        return -1;
+    }
+
+    size_t firstRun = 0;
+    size_t lastRun = restarts.size();
+    if (sorted) {
+        // Last restart whose key is <= key
+        size_t low = 0, high = restarts.size();
+        while (high - low > 1) {
+            size_t middle = (low + high) / 2;
+            const uint8_t* cursor = bytes.data() + restarts[middle];
+            if (getVarint(cursor) <= key) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        firstRun = low;
+        lastRun = low + 1;
+    }
+
+    for (size_t run = firstRun; run < lastRun; run++) {
+        const uint8_t* cursor = bytes.data() + restarts[run];
+        size_t ordinal = run * interval;
+        size_t end = ordinal + interval < count ? ordinal + interval : count;
+        int64_t value = getVarint(cursor);
+        while (true) {
+            if (value == key) {
+                return static_cast<int>(ordinal);
+            }
+            if (sorted && value > key) {
+                return -1;
+            }
+            if (++ordinal >= end) {
+                break;
+            }
+            value += getVarint(cursor);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Decodes the key at a position.
+ *
+ * @param ordinal Position in record order.
+ * @return The key.
+ */
+int KeyColumn::keyAt(size_t ordinal) const {
+    const uint8_t* cursor = bytes.data() + restarts[ordinal / interval];
+    int64_t value = getVarint(cursor);
+    for (size_t i = ordinal % interval; i > 0; i--) {
+        value += getVarint(cursor);
+    }
+    return static_cast<int>(value);
+}
+
+/**
+ * @brief Decodes every key in record order.
+ *
+ * @return The keys.
+ */
+vector<int> KeyColumn::decode() const {
+    vector<int> keys;
+    keys.reserve(count);
+    const uint8_t* cursor = bytes.data();
+    int64_t value = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t stored = getVarint(cursor);
+        value = (i % interval == 0) ? stored : value + stored;
+        keys.push_back(static_cast<int>(value));
+    }
+    return keys;
+}
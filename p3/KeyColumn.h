@@ -0,0 +1,90 @@
+/**
+ * @file KeyColumn.h
+ * @brief Declaration of the compact, searchable zip code column of a block.
+ *
+ * The zip codes of a block are stored apart from the record payload as varint
+ * deltas. Every `restartInterval` keys a restart point stores the full key, so a
+ * lookup binary searches the restart points and decodes at most one run of deltas.
+ * Dense zips such as 1001, 1002, 1003 take one byte per key.
+ *
+ * The column exists only in memory and is built whenever a block is loaded or
+ * updated. The block file keeps its own key encoding: raw payloads hold each
+ * zip as text, and the dictionary codec stores them as text deltas (see
+ * BlockCodec.h). The one byte per key saving is therefore a memory saving, not
+ * a saving in file size.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef KEY_COLUMN_H
+#define KEY_COLUMN_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class KeyColumn
+ * @brief Delta and varint encoded key column with restart points.
+ */
+class KeyColumn {
+public:
+    KeyColumn();
+
+    /**
+     * @brief Encodes the keys of a block.
+     * @param keys Keys in record order; binary search is used when they are ascending.
+     * @param restartInterval Number of keys between two restart points.
+     */
+    void build(const std::vector<int>& keys, size_t restartInterval = 16);
+
+    /**
+     * @brief Finds the ordinal of a key.
+     * @param key Key to look for.
+     * @return Position of the key in record order, or -1 if it is not in the column.
+     */
+    int find(int key) const;
+
+    /**
+     * @brief Decodes the key at a position.
+     * @param ordinal Position in record order.
+     * @return The key.
+     */
+    int keyAt(size_t ordinal) const;
+
+    /**
+     * @brief Decodes every key in record order.
+     * @return The keys.
+     */
+    std::vector<int> decode() const;
+
+    /**
+     * @brief Gets the number of keys in the column.
+     * @return Number of keys.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Gets the encoded size of the column.
+     * @return Number of bytes used by deltas and restart points.
+     */
+    size_t byteSize() const { return bytes.size() + restarts.size() * sizeof(uint32_t); }
+
+    /**
+     * @brief Checks whether the keys are ascending, which enables binary search.
+     * @return True if the keys are sorted.
+     */
+    bool isSorted() const { return sorted; }
+
+private:
+    std::vector<uint8_t> bytes;      ///< Zigzag varints: full keys at restarts, deltas elsewhere
+    std::vector<uint32_t> restarts;  ///< Byte offset of every restart point
+    size_t count;                    ///< Number of keys
+    size_t interval;                 ///< Keys per restart run
+    bool sorted;                     ///< True if keys are ascending
+
+    static void putVarint(std::vector<uint8_t>& out, int64_t value);
+    static int64_t getVarint(const uint8_t*& cursor);
+};
+
+#endif // KEY_COLUMN_H
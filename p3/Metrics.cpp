@@ -0,0 +1,298 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Counters, indexed by `Counter`.
+ */
+static atomic<uint64_t> counters[static_cast<size_t>(Counter::Count)];
+
+/**
+ * @brief Histograms, indexed by `Histogram`.
+ */
+static LatencyHistogram histograms[static_cast<size_t>(Histogram::Count)];
+
+/**
+ * @brief Creates an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+/**
+ * @brief Finds the bucket holding a value.
+ *
+ * @param value Value to place.
+ * @return Index of its bucket.
+ */
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < EXACT) {
+        return static_cast<size_t>(value);
+    }
+    int highestBit = 63 - __builtin_clzll(value);  // At least 7
+    int shift = highestBit - 6;
+    return EXACT + static_cast<size_t>(highestBit - 7) * SUB_BUCKETS + static_cast<size_t>((value >> shift) - SUB_BUCKETS);
+}
+
+/**
+ * @brief Gets the largest value a bucket holds.
+ *
+ * @param bucket Index of the bucket.
+ * @return Its largest value.
+ */
+uint64_t LatencyHistogram::highestIn(size_t bucket) {
+    if (bucket < EXACT) {
+        return bucket;
+    }
+    size_t octave = (bucket - EXACT) / SUB_BUCKETS;
+    uint64_t sub = (bucket - EXACT) % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << (octave + 1)) - 1;
+}
+
+/**
+ * @brief Adds one value.
+ *
+ * @param value Value to add.
+ */
+void LatencyHistogram::record(uint64_t value) {
+    buckets[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+    total.fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(value, memory_order_relaxed);
+    uint64_t seen = smallest.load(memory_order_relaxed);
+    while (value < seen && !smallest.compare_exchange_weak(seen, value, memory_order_relaxed)) {
+    }
+    seen = largest.load(memory_order_relaxed);
+    while (value > seen && !largest.compare_exchange_weak(seen, value, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Gets the value below which a fraction of the recorded values fall.
+ *
+ * @param fraction Fraction between 0 and 1, e.g. 0.99 for p99.
+ * @return The largest value of the bucket holding that rank, or 0 if empty.
+ */
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t recorded = count();
+    if (recorded == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(ceil(fraction * recorded));
+    rank = rank == 0 ? 1 : rank;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += buckets[bucket].load(memory_order_relaxed);
+        if (seen >= rank) {
+            return min(highestIn(bucket), maximum());
+        }
+    }
+    return maximum();
+}
+
+/**
+ * @brief Gets the smallest recorded value.
+ *
+ * @return The smallest value, or 0 if empty.
+ */
+uint64_t LatencyHistogram::minimum() const {
+    return count() ? smallest.load(memory_order_relaxed) : 0;
+}
+
+/**
+ * @brief Gets the mean of the recorded values.
+ *
+ * @return The mean, or 0 if empty.
+ */
+double LatencyHistogram::mean() const {
+    uint64_t recorded = count();
+    return recorded ? static_cast<double>(sum.load(memory_order_relaxed)) / recorded : 0.0;
+}
+
+/**
+ * @brief Forgets every recorded value.
+ */
+void LatencyHistogram::reset() {
+    for (atomic<uint64_t>& bucket : buckets) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    total.store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+    smallest.store(UINT64_MAX, memory_order_relaxed);
+    largest.store(0, memory_order_relaxed);
+}
+
+/**
+ * @brief Adds to a counter.
+ *
+ * @param counter Counter to add to.
+ * @param amount Amount to add.
+ */
+void Metrics::increment(Counter counter, uint64_t amount) {
+    counters[static_cast<size_t>(counter)].fetch_add(amount, memory_order_relaxed);
+}
+
+/**
+ * @brief Adds one value to a histogram.
+ *
+ * @param histogram Histogram to add to.
+ * @param value Value to add.
+ */
+void Metrics::record(Histogram histogram, uint64_t value) {
+    histograms[static_cast<size_t>(histogram)].record(value);
+}
+
+/**
+ * @brief Gets the value of a counter.
+ *
+ * @param counter Counter to read.
+ * @return Its value.
+ */
+uint64_t Metrics::counter(Counter counter) {
+    return counters[static_cast<size_t>(counter)].load(memory_order_relaxed);
+}
+
+/**
+ * @brief Gets a histogram.
+ *
+ * @param histogram Histogram to read.
+ * @return The histogram.
+ */
+const LatencyHistogram& Metrics::histogram(Histogram histogram) {
+    return histograms[static_cast<size_t>(histogram)];
+}
+
+/**
+ * @brief Gets the name of a counter as used in reports.
+ *
+ * @param counter Counter to name.
+ * @return Its name.
+ */
+const char* Metrics::name(Counter counter) {
+    switch (counter) {
+        case Counter::BlockReads: return "block_reads";
+        case Counter::BlockDecodes: return "block_decodes";
+        case Counter::BlockWrites: return "block_writes";
+        case Counter::BlockUpdates: return "block_updates";
+        case Counter::IndexLookups: return "index_lookups";
+        case Counter::IndexMisses: return "index_misses";
+        case Counter::BloomRejects: return "bloom_rejects";
+        case Counter::RecordsParsed: return "records_parsed";
+        case Counter::ChecksumVerifies: return "checksum_verifies";
+        case Counter::ChecksumFailures: return "checksum_failures";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Gets the name of a histogram as used in reports.
+ *
+ * @param histogram Histogram to name.
+ * @return Its name, with its unit.
+ */
+const char* Metrics::name(Histogram histogram) {
+    switch (histogram) {
+        case Histogram::BlockRead: return "block_read_ns";
+        case Histogram::BlockDecode: return "block_decode_ns";
+        case Histogram::IndexLookup: return "index_lookup_ns";
+        case Histogram::RangeScan: return "range_scan_ns";
+        case Histogram::RecordParse: return "record_parse_ns";
+        case Histogram::BlocksPerQuery: return "blocks_per_query";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Checks whether the metrics were compiled in.
+ *
+ * @return False if built with `ZIPDB_NO_METRICS`.
+ */
+bool Metrics::enabled() {
+#ifndef ZIPDB_NO_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Zeroes every counter and histogram.
+ */
+void Metrics::reset() {
+    for (atomic<uint64_t>& counter : counters) {
+        counter.store(0, memory_order_relaxed);
+    }
+    for (LatencyHistogram& histogram : histograms) {
+        histogram.reset();
+    }
+}
+
+/**
+ * @brief Prints every counter and the count, mean, p50, p99, p999 and max of every histogram.
+ *
+ * @param out Stream to print to.
+ */
+void Metrics::print(ostream& out) {
+    if (!enabled()) {
+        out << "Metrics were compiled out (ZIPDB_NO_METRICS).\n";
+        return;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(Counter::Count); i++) {
+        out << left << setw(20) << name(static_cast<Counter>(i)) << right << setw(12)
+            << counter(static_cast<Counter>(i)) << "\n";
+    }
+    out << "\n" << left << setw(20) << "histogram" << right << setw(10) << "count" << setw(12) << "mean"
+        << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "p999" << setw(12) << "max" << "\n";
+    for (size_t i = 0; i < static_cast<size_t>(Histogram::Count); i++) {
+        const LatencyHistogram& values = histogram(static_cast<Histogram>(i));
+        out << left << setw(20) << name(static_cast<Histogram>(i)) << right << setw(10) << values.count()
+            << setw(12) << fixed << setprecision(1) << values.mean() << setw(10) << values.percentile(0.50)
+            << setw(10) << values.percentile(0.99) << setw(10) << values.percentile(0.999)
+            << setw(12) << values.maximum() << "\n";
+    }
+    out.unsetf(ios::floatfield);
+}
+
+/**
+ * @brief Writes the same report as `print` as one JSON object.
+ *
+ * @param out Stream to write to.
+ */
+void Metrics::writeJson(ostream& out) {
+    out << "{\n  \"enabled\": " << (enabled() ? "true" : "false") << ",\n  \"counters\": {";
+    for (size_t i = 0; i < static_cast<size_t>(Counter::Count); i++) {
+        out << (i ? ",\n" : "\n") << "    \"" << name(static_cast<Counter>(i)) << "\": "
+            << counter(static_cast<Counter>(i));
+    }
+    out << "\n  },\n  \"histograms\": {";
+    for (size_t i = 0; i < static_cast<size_t>(Histogram::Count); i++) {
+        const LatencyHistogram& values = histogram(static_cast<Histogram>(i));
+        out << (i ? ",\n" : "\n") << "    \"" << name(static_cast<Histogram>(i)) << "\": {"
+            << "\"count\": " << values.count() << ", \"min\": " << values.minimum()
+            << ", \"mean\": " << fixed << setprecision(1) << values.mean()
+            << ", \"p50\": " << values.percentile(0.50) << ", \"p99\": " << values.percentile(0.99)
+            << ", \"p999\": " << values.percentile(0.999) << ", \"max\": " << values.maximum() << "}";
+    }
+    out << "\n  }\n}\n";
+    out.unsetf(ios::floatfield);
+}
+
+/**
+ * @brief Writes the JSON report to a file.
+ *
+ * @param path Path of the file, replaced if it exists.
+ * @return True if successful, false otherwise.
+ */
+bool Metrics::writeJson(const string& path) {
+    ofstream file(path, ios::trunc);
+    if (!file.is_open()) {
+        cerr << "Error: Could not open " << path << endl;
+        return false;
+    }
+    writeJson(file);
+    return file.good();
+}
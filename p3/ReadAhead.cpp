@@ -0,0 +1,125 @@
+/**
+ * @file ReadAhead.cpp
+ * @brief Implementation of the background reader that pulls file ranges into the page cache.
+ *
+ * @date 10/18/2026
+ */
+
+#include "ReadAhead.h"
+#include <algorithm>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Largest read issued at once; longer ranges are read in pieces.
+ */
+static const size_t READ_CHUNK = 1 << 20;
+
+/**
+ * @brief Starts the background reader.
+ * @param fd Open file descriptor to read from; stays owned by the caller and must outlive the reader.
+ */
+ReadAhead::ReadAhead(int fd) : fd(fd) {
+    if (fd < 0) {
+        return;
+    }
+    try {
+        worker = thread(&ReadAhead::run, this);
+        running = true;
+    } catch (const system_error&) {
+        // No thread: requests are ignored and reads stay synchronous
+    }
+}
+
+/**
+ * @brief Stops the background thread; ranges not yet read are dropped.
+ */
+ReadAhead::~ReadAhead() {
+    {
+        lock_guard<mutex> guard(latch);
+        stopping = true;
+        queue.clear();
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Queues a range to be read in the background.
+ * @param offset Start of the range in the file.
+ * @param length Length of the range in bytes.
+ */
+void ReadAhead::request(long long offset, size_t length) {
+    if (!running || length == 0) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(latch);
+        if (!queue.empty() && queue.back().first + static_cast<long long>(queue.back().second) >= offset
+            && queue.back().first <= offset) {
+            // Touches the last queued range, so both are read at once
+            long long end = max(queue.back().first + static_cast<long long>(queue.back().second),
+                                offset + static_cast<long long>(length));
+            queue.back().second = static_cast<size_t>(end - queue.back().first);
+        } else {
+            queue.emplace_back(offset, length);
+        }
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Drops the ranges not yet read, such as those past the end of a finished scan.
+ */
+void ReadAhead::cancel() {
+    lock_guard<mutex> guard(latch);
+    queue.clear();
+}
+
+/**
+ * @brief Reads queued ranges until asked to stop.
+ */
+void ReadAhead::run() {
+    vector<char> scratch(READ_CHUNK);
+    unique_lock<mutex> guard(latch);
+    while (true) {
+        wake.wait(guard, [&] { return stopping || !queue.empty(); });
+        if (stopping) {
+            return;
+        }
+        // Take one chunk at a time, so a cancel stops a long range early
+        auto& [offset, length] = queue.front();
+        long long start = offset;
+        size_t count = min(length, READ_CHUNK);
+        offset += static_cast<long long>(count);
+        length -= count;
+        if (length == 0) {
+            queue.pop_front();
+        }
+        guard.unlock();
+
+#ifdef __linux__
+        // Fills the page cache without copying the bytes out
+        if (::readahead(fd, start, count) == 0) {
+            guard.lock();
+            continue;
+        }
+#endif
+        size_t done = 0;
+        while (done < count) {
+            ssize_t read = pread(fd, scratch.data(), count - done, start + static_cast<long long>(done));
+            if (read <= 0) {
+                break;
+            }
+            done += static_cast<size_t>(read);
+        }
+
+        guard.lock();
+    }
+}
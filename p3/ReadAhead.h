@@ -0,0 +1,78 @@
+/**
+ * @file ReadAhead.h
+ * @brief Declaration of the background reader that pulls file ranges into the page cache before they are needed.
+ *
+ * A scan asks for the ranges it will read next, and a background I/O thread
+ * reads them while the scan processes the current block. When the scan
+ * reaches a range, its own pread is served from the page cache instead of
+ * waiting on the disk, so scans over a cold file keep the disk busy instead
+ * of alternating between compute and wait.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <utility>
+
+/**
+ * @class ReadAhead
+ * @brief Reads requested ranges of one file on a background thread.
+ *
+ * Nothing is handed back: the ranges are only read so that the caller's own
+ * reads of them hit the page cache, which keeps the scan free of any locking
+ * per block. Adjacent requests are merged into one read. If the thread
+ * cannot be started, requests are ignored and every read stays synchronous.
+ */
+class ReadAhead {
+public:
+    /**
+     * @brief Starts the background reader.
+     * @param fd Open file descriptor to read from; stays owned by the caller and must outlive the reader.
+     */
+    explicit ReadAhead(int fd);
+
+    /**
+     * @brief Stops the background thread; ranges not yet read are dropped.
+     */
+    ~ReadAhead();
+
+    ReadAhead(const ReadAhead&) = delete;
+    ReadAhead& operator=(const ReadAhead&) = delete;
+
+    /**
+     * @brief Queues a range to be read in the background.
+     * @param offset Start of the range in the file.
+     * @param length Length of the range in bytes.
+     */
+    void request(long long offset, size_t length);
+
+    /**
+     * @brief Drops the ranges not yet read, such as those past the end of a finished scan.
+     */
+    void cancel();
+
+    /**
+     * @brief Tells whether ranges are read in the background at all.
+     * @return true if the background thread is running, false in the synchronous fallback.
+     */
+    bool active() const { return running; }
+
+private:
+    void run();
+
+    int fd;                                               ///< File being read
+    bool running = false;                                 ///< True while the background thread runs
+    bool stopping = false;                                ///< Asks the background thread to exit
+    std::deque<std::pair<long long, size_t>> queue;       ///< Ranges not yet read, as offset and length
+    std::mutex latch;                                     ///< Guards the queue and the flags
+    std::condition_variable wake;                         ///< Signals the thread that work was queued or it should stop
+    std::thread worker;                                   ///< Background I/O thread
+};
+
+#endif // READ_AHEAD_H
@@ -0,0 +1,377 @@
+#include "SequenceSet.h"
+#include "Metrics.h"
+#include <iostream>
+#include <algorithm>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * @brief Constructs an empty sequence set; call `open` before use.
+ */
+SequenceSet::SequenceSet() : headRBN(-1), zipOrdered(true) {}
+
+/**
+ * @brief Extracts the zip code keys of the records in a block.
+ *
+ * @param records Records of a block.
+ * @param keys Receives one key per record, in record order.
+ * @return True if every record starts with a numeric zip code, false otherwise.
+ */
+bool SequenceSet::keysOf(const vector<string>& records, vector<int>& keys) {
+    keys.clear();
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+        try {
+            keys.push_back(stoi(records[i]));
+        }
+        catch (const exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Loads a block file, replays its redo log, and builds the zip code index.
+ *
+ * When updates are logged and the log held entries, they are checkpointed
+ * into the block file right away.
+ *
+ * @param blockFile Path to the block file.
+ * @param logUpdates True to append every update to `<blockFile>.log`.
+ * @return True if successful, false otherwise.
+ */
+bool SequenceSet::open(const string& blockFile, bool logUpdates) {
+    unique_lock<shared_mutex> indexGuard(indexLatch);
+
+    map<int, Block> loaded;
+    headRBN = loadBlockFile(blockFile, loaded);
+    if (headRBN == -1) {
+        return false;
+    }
+
+    // Redo the updates committed since the last checkpoint
+    size_t replayed = replayBlockLog(blockFile, loaded, headRBN);
+
+    blockPath = blockFile;
+    table.clear();
+    index.clear();
+    extremes.clear();
+    zipOrdered = blockFileLayout(blockFile) == BlockLayout::Zip;
+    corruptRBNs.clear();
+    for (auto& [RBN, block] : loaded) {
+        if (block.corrupt) {
+            corruptRBNs.push_back(RBN);
+        }
+        materializeBlock(block);
+        if (!block.isAvailable) {
+            extremes.addRecords(block.records);
+        }
+        auto node = make_unique<LatchedBlock>();
+        node->block = move(block);
+        table[RBN] = move(node);
+    }
+    for (auto& [RBN, node] : table) {
+        auto next = table.find(node->block.successorRBN);
+        node->successor = (next == table.end()) ? nullptr : next->second.get();
+
+        vector<int> keys;
+        keysOf(node->block.records, keys);
+        for (int key : keys) {
+            index[key] = RBN;
+        }
+    }
+
+    if (logUpdates) {
+        log = make_unique<WriteAheadLog>(blockFile + ".log");
+        if (!log->isOpen()) {
+            return false;
+        }
+        // Fold the replayed updates into the block file so the log starts empty
+        return replayed == 0 || checkpointLocked();
+    }
+    log.reset();
+    return true;
+}
+
+/**
+ * @brief Looks up a zip code.
+ *
+ * The index is latched shared only until the target block has been latched.
+ *
+ * @param zip Zip code to search for.
+ * @param fields Receives the fields of the matching record.
+ * @return True if the zip code was found, false otherwise.
+ */
+bool SequenceSet::search(const string& zip, vector<string>& fields) const {
+    METRICS_TIME(Histogram::IndexLookup);
+    METRICS_COUNT(Counter::IndexLookups, 1);
+    int key;
+    try {
+        key = stoi(zip);
+    }
+    catch (const exception&) {
+        return false;
+    }
+
+    shared_lock<shared_mutex> indexGuard(indexLatch);
+    auto entry = index.find(key);
+    if (entry == index.end()) {
+        METRICS_COUNT(Counter::IndexMisses, 1);
+        METRICS_RECORD(Histogram::BlocksPerQuery, 0);
+        return false;
+    }
+    const LatchedBlock* node = table.at(entry->second).get();
+    shared_lock<shared_mutex> blockGuard(node->latch);
+    indexGuard.unlock();
+
+    METRICS_RECORD(Histogram::BlocksPerQuery, 1);
+    bool found = findRecordInBlock(node->block, to_string(key), fields);
+    METRICS_COUNT(Counter::IndexMisses, found ? 0 : 1);
+    return found;
+}
+
+/**
+ * @brief Visits every record whose zip code lies in [lowZip, highZip], in key order.
+ *
+ * The scan descends through the index to the first block of the range and then
+ * crabs along the successor chain, latching each block before releasing the
+ * previous one. Blocks laid out in Hilbert order are not chained by key, so
+ * there the scan walks the index range instead and latches one block at a time.
+ *
+ * @param lowZip Smallest zip code of the range.
+ * @param highZip Largest zip code of the range.
+ * @param visit Callback receiving the fields of each record in the range.
+ * @return Number of records visited.
+ */
+size_t SequenceSet::rangeScan(int lowZip, int highZip,
+                              const function<void(const vector<string>&)>& visit) const {
+    METRICS_TIME(Histogram::RangeScan);
+    shared_lock<shared_mutex> indexGuard(indexLatch);
+    if (!zipOrdered) {
+        vector<pair<int, const LatchedBlock*>> entries;
+        for (auto entry = index.lower_bound(lowZip); entry != index.end() && entry->first <= highZip; ++entry) {
+            entries.emplace_back(entry->first, table.at(entry->second).get());
+        }
+        indexGuard.unlock();
+
+        size_t visited = 0;
+        size_t blocksTouched = 0;
+        const LatchedBlock* previous = nullptr;
+        vector<string> fields;
+        for (const auto& [key, node] : entries) {
+            blocksTouched += node != previous;
+            previous = node;
+            shared_lock<shared_mutex> blockGuard(node->latch);
+            if (findRecordInBlock(node->block, to_string(key), fields)) {
+                visit(fields);
+                visited++;
+            }
+        }
+        METRICS_RECORD(Histogram::BlocksPerQuery, blocksTouched);
+        return visited;
+    }
+
+    auto entry = index.lower_bound(lowZip);
+    if (entry == index.end() || entry->first > highZip) {
+        METRICS_RECORD(Histogram::BlocksPerQuery, 0);
+        return 0;
+    }
+    const LatchedBlock* node = table.at(entry->second).get();
+    shared_lock<shared_mutex> blockGuard(node->latch);
+    indexGuard.unlock();
+
+    size_t visited = 0;
+    size_t blocksTouched = 0;
+    vector<int> keys;
+    vector<string> fields;
+    while (node) {
+        blocksTouched++;
+        const vector<string>& records = node->block.records;
+        keysOf(records, keys);
+
+        vector<size_t> hits;
+        bool pastRange = false;
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] > highZip) {
+                pastRange = true;
+            } else if (keys[i] >= lowZip) {
+                hits.push_back(i);
+            }
+        }
+        sort(hits.begin(), hits.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+        for (size_t i : hits) {
+            auto first = records.begin() + i * FIELDS_PER_RECORD;
+            fields.assign(first, first + FIELDS_PER_RECORD);
+            visit(fields);
+            visited++;
+        }
+
+        if (pastRange || !node->successor) {
+            break;
+        }
+        const LatchedBlock* next = node->successor;
+        shared_lock<shared_mutex> nextGuard(next->latch);
+        blockGuard.swap(nextGuard);
+        node = next;
+    }
+    METRICS_RECORD(Histogram::BlocksPerQuery, blocksTouched);
+    return visited;
+}
+
+/**
+ * @brief Replaces the records of a block, logging the new image first.
+ *
+ * An update that keeps the key set of the block only holds the index latch
+ * shared while it latches the block. An update that changes the keys retries
+ * with the index latched exclusively so the index can be adjusted.
+ *
+ * @param RBN Relative Block Number of the block to update.
+ * @param records New records of the block.
+ * @return True if successful, false otherwise.
+ */
+bool SequenceSet::updateBlock(int RBN, const vector<string>& records) {
+    vector<int> newKeys;
+    if (!keysOf(records, newKeys)) {
+        cerr << "Error: Block " << RBN << " contains a malformed zip code." << endl;
+        return false;
+    }
+
+    auto apply = [&](LatchedBlock* node) {
+        if (log && log->append(RBN, joinRecords(records)) == 0) {
+            cerr << "Error: Could not log update of block " << RBN << endl;
+            return false;
+        }
+        if (!node->block.isAvailable) {
+            lock_guard<mutex> extremesGuard(extremesLatch);
+            extremes.removeRecords(node->block.records);
+            extremes.addRecords(records);
+        }
+        setBlockRecords(node->block, records);
+        return true;
+    };
+
+    {
+        shared_lock<shared_mutex> indexGuard(indexLatch);
+        auto it = table.find(RBN);
+        if (it == table.end()) {
+            cerr << "Block with RBN " << RBN << " not found." << endl;
+            return false;
+        }
+        LatchedBlock* node = it->second.get();
+        unique_lock<shared_mutex> blockGuard(node->latch);
+
+        vector<int> oldKeys;
+        keysOf(node->block.records, oldKeys);
+        if (oldKeys == newKeys) {
+            indexGuard.unlock();
+            return apply(node);
+        }
+    }
+
+    unique_lock<shared_mutex> indexGuard(indexLatch);
+    auto it = table.find(RBN);
+    if (it == table.end()) {
+        return false;
+    }
+    LatchedBlock* node = it->second.get();
+    unique_lock<shared_mutex> blockGuard(node->latch);
+
+    vector<int> oldKeys;
+    keysOf(node->block.records, oldKeys);
+    if (!apply(node)) {
+        return false;
+    }
+    for (int key : oldKeys) {
+        auto entry = index.find(key);
+        if (entry != index.end() && entry->second == RBN) {
+            index.erase(entry);
+        }
+    }
+    for (int key : newKeys) {
+        index[key] = RBN;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the extreme zip codes of a state, kept current by `updateBlock`.
+ *
+ * @param state Two letter state code.
+ * @param report Receives the four extreme zip codes.
+ * @return True if the state has records, false otherwise.
+ */
+bool SequenceSet::stateExtremes(const string& state, StateExtremeReport& report) const {
+    lock_guard<mutex> extremesGuard(extremesLatch);
+    return extremes.extremes(state, report);
+}
+
+/**
+ * @brief Gets the states that have records.
+ *
+ * @return State codes in alphabetical order.
+ */
+vector<string> SequenceSet::states() const {
+    lock_guard<mutex> extremesGuard(extremesLatch);
+    return extremes.states();
+}
+
+/**
+ * @brief Forces logged updates to stable storage.
+ * @return True if successful or updates are not logged, false otherwise.
+ */
+bool SequenceSet::flush() {
+    return !log || log->sync();
+}
+
+/**
+ * @brief Writes the blocks back to the block file and empties the redo log.
+ *
+ * The index latch is held exclusively throughout, so no update can start, and
+ * each block is latched shared while it is copied so that updates already past
+ * the index finish first.
+ *
+ * @return True if successful, false otherwise.
+ */
+bool SequenceSet::checkpoint() {
+    unique_lock<shared_mutex> indexGuard(indexLatch);
+    return checkpointLocked();
+}
+
+/**
+ * @brief Performs the checkpoint; the caller must hold the index latch exclusively.
+ * @return True if successful, false otherwise.
+ */
+bool SequenceSet::checkpointLocked() {
+    if (blockPath.empty()) {
+        return false;
+    }
+
+    map<int, Block> snapshot;
+    for (const auto& [RBN, node] : table) {
+        shared_lock<shared_mutex> blockGuard(node->latch);
+        snapshot[RBN] = node->block;
+    }
+    if (!flush() || !writeBlockFile(blockPath, snapshot, headRBN)) {
+        return false;
+    }
+    return !log || log->truncate();
+}
+
+/**
+ * @brief Gets the blocks that failed their checksum when the file was opened.
+ * @return RBNs of the corrupted blocks, which hold no records, in ascending order.
+ */
+vector<int> SequenceSet::corruptBlocks() const {
+    shared_lock<shared_mutex> indexGuard(indexLatch);
+    return corruptRBNs;
+}
+
+/**
+ * @brief Gets the number of blocks in the handle.
+ * @return Number of blocks.
+ */
+size_t SequenceSet::blockCount() const {
+    shared_lock<shared_mutex> indexGuard(indexLatch);
+    return table.size();
+}
@@ -0,0 +1,136 @@
+/**
+ * @file SequenceSet.h
+ * @brief Declaration of a thread-safe handle over a blocked sequence set file.
+ *
+ * Unlike the global `blocks` map, a SequenceSet owns its own block table and an
+ * in-memory zip code index. Readers take shared latches on the blocks they visit,
+ * writers take exclusive latches, and both descend from the index to the blocks
+ * with latch crabbing so many lookups can run in parallel.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef SEQUENCE_SET_H
+#define SEQUENCE_SET_H
+
+#include "Block.h"
+#include "WriteAheadLog.h"
+#include "StateExtremes.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <shared_mutex>
+#include <mutex>
+
+/**
+ * @class SequenceSet
+ * @brief Blocked sequence set that can be searched and updated from many threads.
+ *
+ * Latches are always acquired index first, then block, and successor blocks are
+ * latched before their predecessor is released. Blocks are never freed while the
+ * handle is open, so a block pointer stays valid once it has been reached.
+ */
+class SequenceSet {
+public:
+    SequenceSet();
+
+    /**
+     * @brief Loads a block file, replays its redo log, and builds the zip code index.
+     * @param blockFile Path to the block file.
+     * @param logUpdates True to append every update to `<blockFile>.log`.
+     * @return True if successful, false otherwise.
+     */
+    bool open(const std::string& blockFile, bool logUpdates = true);
+
+    /**
+     * @brief Looks up a zip code.
+     * @param zip Zip code to search for.
+     * @param fields Receives the fields of the matching record.
+     * @return True if the zip code was found, false otherwise.
+     */
+    bool search(const std::string& zip, std::vector<std::string>& fields) const;
+
+    /**
+     * @brief Visits every record whose zip code lies in [lowZip, highZip], in key order.
+     * @param lowZip Smallest zip code of the range.
+     * @param highZip Largest zip code of the range.
+     * @param visit Callback receiving the fields of each record in the range.
+     * @return Number of records visited.
+     */
+    size_t rangeScan(int lowZip, int highZip,
+                     const std::function<void(const std::vector<std::string>&)>& visit) const;
+
+    /**
+     * @brief Replaces the records of a block, logging the new image first.
+     * @param RBN Relative Block Number of the block to update.
+     * @param records New records of the block.
+     * @return True if successful, false otherwise.
+     */
+    bool updateBlock(int RBN, const std::vector<std::string>& records);
+
+    /**
+     * @brief Gets the extreme zip codes of a state, kept current by `updateBlock`.
+     * @param state Two letter state code.
+     * @param report Receives the four extreme zip codes.
+     * @return True if the state has records, false otherwise.
+     */
+    bool stateExtremes(const std::string& state, StateExtremeReport& report) const;
+
+    /**
+     * @brief Gets the states that have records.
+     * @return State codes in alphabetical order.
+     */
+    std::vector<std::string> states() const;
+
+    /**
+     * @brief Forces logged updates to stable storage.
+     * @return True if successful or updates are not logged, false otherwise.
+     */
+    bool flush();
+
+    /**
+     * @brief Writes the blocks back to the block file and empties the redo log.
+     * @return True if successful, false otherwise.
+     */
+    bool checkpoint();
+
+    /**
+     * @brief Gets the blocks that failed their checksum when the file was opened.
+     * @return RBNs of the corrupted blocks, which hold no records, in ascending order.
+     */
+    std::vector<int> corruptBlocks() const;
+
+    /**
+     * @brief Gets the number of blocks in the handle.
+     * @return Number of blocks.
+     */
+    size_t blockCount() const;
+
+private:
+    /**
+     * @brief A block together with the latch protecting it.
+     */
+    struct LatchedBlock {
+        Block block;                         ///< Block contents
+        LatchedBlock* successor = nullptr;   ///< Next block of the active list
+        mutable std::shared_mutex latch;     ///< Shared for readers, exclusive for writers
+    };
+
+    std::map<int, std::unique_ptr<LatchedBlock>> table;  ///< Blocks by RBN
+    std::map<int, int> index;                            ///< Zip code to RBN
+    mutable std::shared_mutex indexLatch;                ///< Protects `index` and `table`
+    std::unique_ptr<WriteAheadLog> log;                  ///< Redo log, if updates are logged
+    std::string blockPath;                               ///< Block file the handle was opened from
+    int headRBN;                                         ///< Head of the active list
+    std::vector<int> corruptRBNs;                        ///< Blocks that failed their checksum on open
+    bool zipOrdered;                                     ///< True if the successor chain is in key order
+    StateExtremes extremes;                              ///< Extreme zip codes of every state
+    mutable std::mutex extremesLatch;                    ///< Protects `extremes`
+
+    bool checkpointLocked();
+    static bool keysOf(const std::vector<std::string>& records, std::vector<int>& keys);
+};
+
+#endif // SEQUENCE_SET_H
@@ -0,0 +1,335 @@
+#include "SnapshotSet.h"
+#include "Metrics.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Parses the zip code of every record of a block.
+ *
+ * @param records Records of a block.
+ * @param keys Receives one key per record, in record order.
+ * @return True if every record starts with a numeric zip code, false otherwise.
+ */
+static bool recordKeys(const vector<string>& records, vector<int>& keys) {
+    keys.clear();
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+        try {
+            keys.push_back(stoi(records[i]));
+        }
+        catch (const exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs an empty snapshot set.
+ */
+SnapshotSet::SnapshotSet() : current(new BlockTable{{}, make_shared<const map<int, int>>()}), headRBN(-1) {}
+
+/**
+ * @brief Frees the current table and all of its blocks.
+ */
+SnapshotSet::~SnapshotSet() {
+    const BlockTable* table = current.load();
+    for (const auto& [RBN, block] : table->blocks) {
+        delete block;
+    }
+    delete table;
+}
+
+/**
+ * @brief Builds the first table version from a block map such as the global `blocks`.
+ *
+ * @param source Blocks to copy.
+ */
+void SnapshotSet::build(const map<int, Block>& source) {
+    lock_guard<mutex> guard(writerLatch);
+
+    BlockTable* next = new BlockTable;
+    auto index = make_shared<map<int, int>>();
+    vector<int> keys;
+    for (const auto& [RBN, block] : source) {
+        Block* version = new Block(block);
+        materializeBlock(*version);
+        next->blocks[RBN] = version;
+        recordKeys(version->records, keys);
+        for (int key : keys) {
+            (*index)[key] = RBN;
+        }
+    }
+    next->index = index;
+
+    // Every block of the previous table is replaced, not shared
+    const BlockTable* previous = current.load();
+    vector<const Block*> replaced;
+    for (const auto& [RBN, block] : previous->blocks) {
+        replaced.push_back(block);
+    }
+    publish(next);
+    epochs.retire([replaced]() {
+        for (const Block* block : replaced) {
+            delete block;
+        }
+    });
+    epochs.reclaim();
+}
+
+/**
+ * @brief Loads a block file, replays its redo log, and builds the first table version.
+ *
+ * When updates are logged and the log held entries, they are checkpointed
+ * into the block file right away.
+ *
+ * @param blockFile Path to the block file.
+ * @param logUpdates True to append every update to `<blockFile>.log`.
+ * @return True if successful, false otherwise.
+ */
+bool SnapshotSet::open(const string& blockFile, bool logUpdates) {
+    map<int, Block> loaded;
+    headRBN = loadBlockFile(blockFile, loaded);
+    if (headRBN == -1) {
+        return false;
+    }
+    size_t replayed = replayBlockLog(blockFile, loaded, headRBN);
+    build(loaded);
+
+    lock_guard<mutex> guard(writerLatch);
+    blockPath = blockFile;
+    if (logUpdates) {
+        log = make_unique<WriteAheadLog>(blockFile + ".log");
+        if (!log->isOpen()) {
+            return false;
+        }
+        // Fold the replayed updates into the block file so the log starts empty
+        return replayed == 0 || checkpointLocked();
+    }
+    log.reset();
+    return true;
+}
+
+/**
+ * @brief Looks up a zip code in the current snapshot.
+ *
+ * @param zip Zip code to search for.
+ * @param fields Receives the fields of the matching record.
+ * @return True if the zip code was found, false otherwise.
+ */
+bool SnapshotSet::search(const string& zip, vector<string>& fields) const {
+    METRICS_TIME(Histogram::IndexLookup);
+    METRICS_COUNT(Counter::IndexLookups, 1);
+    int key;
+    try {
+        key = stoi(zip);
+    }
+    catch (const exception&) {
+        return false;
+    }
+
+    EpochManager::Guard pinned = epochs.pin();
+    const BlockTable* table = current.load();
+    auto entry = table->index->find(key);
+    if (entry == table->index->end()) {
+        METRICS_COUNT(Counter::IndexMisses, 1);
+        METRICS_RECORD(Histogram::BlocksPerQuery, 0);
+        return false;
+    }
+    auto block = table->blocks.find(entry->second);
+    bool found = block != table->blocks.end() && findRecordInBlock(*block->second, to_string(key), fields);
+    METRICS_RECORD(Histogram::BlocksPerQuery, block != table->blocks.end() ? 1 : 0);
+    METRICS_COUNT(Counter::IndexMisses, found ? 0 : 1);
+    return found;
+}
+
+/**
+ * @brief Visits every record whose zip code lies in [lowZip, highZip] in one snapshot.
+ *
+ * @param lowZip Smallest zip code of the range.
+ * @param highZip Largest zip code of the range.
+ * @param visit Callback receiving the fields of each record in the range.
+ * @return Number of records visited.
+ */
+size_t SnapshotSet::rangeScan(int lowZip, int highZip,
+                              const function<void(const vector<string>&)>& visit) const {
+    METRICS_TIME(Histogram::RangeScan);
+    EpochManager::Guard pinned = epochs.pin();
+    const BlockTable* table = current.load();
+
+    size_t visited = 0;
+    size_t blocksTouched = 0;
+    int previousRBN = -1;
+    vector<string> fields;
+    auto end = table->index->upper_bound(highZip);
+    for (auto entry = table->index->lower_bound(lowZip); entry != end; ++entry) {
+        blocksTouched += entry->second != previousRBN;
+        previousRBN = entry->second;
+        auto block = table->blocks.find(entry->second);
+        if (block != table->blocks.end() && findRecordInBlock(*block->second, to_string(entry->first), fields)) {
+            visit(fields);
+            visited++;
+        }
+    }
+    METRICS_RECORD(Histogram::BlocksPerQuery, blocksTouched);
+    return visited;
+}
+
+/**
+ * @brief Publishes a new version of one block.
+ *
+ * @param RBN Relative Block Number of the block to update.
+ * @param records New records of the block.
+ * @return True if successful, false otherwise.
+ */
+bool SnapshotSet::updateBlock(int RBN, const vector<string>& records) {
+    return updateBlocks({{RBN, records}});
+}
+
+/**
+ * @brief Publishes new versions of several blocks as a single snapshot.
+ *
+ * The new table shares every untouched block with the previous one; the index
+ * is copied only if the update adds or removes zip codes.
+ *
+ * @param updates Pairs of RBN and new records.
+ * @return True if successful, false otherwise.
+ */
+bool SnapshotSet::updateBlocks(const vector<pair<int, vector<string>>>& updates) {
+    lock_guard<mutex> guard(writerLatch);
+    const BlockTable* previous = current.load();
+
+    vector<int> oldKeys, newKeys;
+    for (const auto& [RBN, records] : updates) {
+        if (previous->blocks.find(RBN) == previous->blocks.end()) {
+            cerr << "Block with RBN " << RBN << " not found." << endl;
+            return false;
+        }
+        if (!recordKeys(records, newKeys)) {
+            cerr << "Error: Block " << RBN << " contains a malformed zip code." << endl;
+            return false;
+        }
+    }
+
+    BlockTable* next = new BlockTable(*previous);
+    shared_ptr<map<int, int>> index;
+    vector<const Block*> replaced;
+    for (const auto& [RBN, records] : updates) {
+        if (log && log->append(RBN, joinRecords(records)) == 0) {
+            cerr << "Error: Could not log update of block " << RBN << endl;
+            delete next;
+            return false;
+        }
+
+        const Block* old = next->blocks[RBN];
+        Block* version = new Block(*old);
+        setBlockRecords(*version, records);
+
+        recordKeys(old->records, oldKeys);
+        recordKeys(records, newKeys);
+        if (oldKeys != newKeys) {
+            if (!index) {
+                index = make_shared<map<int, int>>(*previous->index);
+            }
+            for (int key : oldKeys) {
+                auto entry = index->find(key);
+                if (entry != index->end() && entry->second == RBN) {
+                    index->erase(entry);
+                }
+            }
+            for (int key : newKeys) {
+                (*index)[key] = RBN;
+            }
+        }
+
+        if (find(replaced.begin(), replaced.end(), old) == replaced.end()) {
+            replaced.push_back(old);
+        }
+        next->blocks[RBN] = version;
+    }
+    if (index) {
+        next->index = index;
+    }
+
+    publish(next);
+    epochs.retire([replaced]() {
+        for (const Block* block : replaced) {
+            delete block;
+        }
+    });
+    epochs.reclaim();
+    return true;
+}
+
+/**
+ * @brief Installs a new table and retires the previous one; the caller holds the writer latch.
+ *
+ * @param next Table to publish.
+ */
+void SnapshotSet::publish(BlockTable* next) {
+    const BlockTable* previous = current.exchange(next);
+    epochs.retire([previous]() { delete previous; });
+}
+
+/**
+ * @brief Forces logged updates to stable storage.
+ * @return True if successful or updates are not logged, false otherwise.
+ */
+bool SnapshotSet::flush() {
+    lock_guard<mutex> guard(writerLatch);
+    return !log || log->sync();
+}
+
+/**
+ * @brief Writes the current snapshot back to the block file and empties the redo log.
+ *
+ * Writers are held off until the log has been emptied; readers keep running.
+ *
+ * @return True if successful, false otherwise.
+ */
+bool SnapshotSet::checkpoint() {
+    lock_guard<mutex> guard(writerLatch);
+    return checkpointLocked();
+}
+
+/**
+ * @brief Performs the checkpoint; the caller holds the writer latch.
+ * @return True if successful, false otherwise.
+ */
+bool SnapshotSet::checkpointLocked() {
+    if (blockPath.empty()) {
+        return false;
+    }
+
+    // Only writers replace the table, so it stays alive while the latch is held
+    map<int, Block> snapshot;
+    for (const auto& [RBN, block] : current.load()->blocks) {
+        snapshot[RBN] = *block;
+    }
+    if ((log && !log->sync()) || !writeBlockFile(blockPath, snapshot, headRBN)) {
+        return false;
+    }
+    return !log || log->truncate();
+}
+
+/**
+ * @brief Gets the number of replaced tables and blocks not yet freed.
+ *
+ * Versions are freed by the update that follows the departure of the last
+ * reader that could see them.
+ *
+ * @return Number of retired versions some reader may still see.
+ */
+size_t SnapshotSet::retiredVersions() const {
+    return epochs.pendingReclaims();
+}
+
+/**
+ * @brief Gets the number of blocks in the current snapshot.
+ * @return Number of blocks.
+ */
+size_t SnapshotSet::blockCount() const {
+    EpochManager::Guard pinned = epochs.pin();
+    return current.load()->blocks.size();
+}
@@ -0,0 +1,130 @@
+/**
+ * @file SnapshotSet.h
+ * @brief Declaration of a copy-on-write sequence set with lock-free readers.
+ *
+ * Readers pin an epoch and dereference the current immutable block table without
+ * taking any latch. Writers build new versions of the blocks they change, publish
+ * a new table with one atomic store, and retire the replaced versions, which are
+ * freed by epoch-based reclamation once no reader can still see them.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef SNAPSHOT_SET_H
+#define SNAPSHOT_SET_H
+
+#include "Block.h"
+#include "EpochManager.h"
+#include "WriteAheadLog.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+/**
+ * @class SnapshotSet
+ * @brief Multi-version block table; lookups never wait for writers.
+ */
+class SnapshotSet {
+public:
+    SnapshotSet();
+    ~SnapshotSet();
+
+    SnapshotSet(const SnapshotSet&) = delete;
+    SnapshotSet& operator=(const SnapshotSet&) = delete;
+
+    /**
+     * @brief Builds the first table version from a block map such as the global `blocks`.
+     * @param source Blocks to copy.
+     */
+    void build(const std::map<int, Block>& source);
+
+    /**
+     * @brief Loads a block file, replays its redo log, and builds the first table version.
+     * @param blockFile Path to the block file.
+     * @param logUpdates True to append every update to `<blockFile>.log`.
+     * @return True if successful, false otherwise.
+     */
+    bool open(const std::string& blockFile, bool logUpdates = true);
+
+    /**
+     * @brief Looks up a zip code in the current snapshot.
+     * @param zip Zip code to search for.
+     * @param fields Receives the fields of the matching record.
+     * @return True if the zip code was found, false otherwise.
+     */
+    bool search(const std::string& zip, std::vector<std::string>& fields) const;
+
+    /**
+     * @brief Visits every record whose zip code lies in [lowZip, highZip] in one snapshot.
+     * @param lowZip Smallest zip code of the range.
+     * @param highZip Largest zip code of the range.
+     * @param visit Callback receiving the fields of each record in the range.
+     * @return Number of records visited.
+     */
+    size_t rangeScan(int lowZip, int highZip,
+                     const std::function<void(const std::vector<std::string>&)>& visit) const;
+
+    /**
+     * @brief Publishes a new version of one block.
+     * @param RBN Relative Block Number of the block to update.
+     * @param records New records of the block.
+     * @return True if successful, false otherwise.
+     */
+    bool updateBlock(int RBN, const std::vector<std::string>& records);
+
+    /**
+     * @brief Publishes new versions of several blocks as a single snapshot.
+     * @param updates Pairs of RBN and new records.
+     * @return True if successful, false otherwise.
+     */
+    bool updateBlocks(const std::vector<std::pair<int, std::vector<std::string>>>& updates);
+
+    /**
+     * @brief Forces logged updates to stable storage.
+     * @return True if successful or updates are not logged, false otherwise.
+     */
+    bool flush();
+
+    /**
+     * @brief Writes the current snapshot back to the block file and empties the redo log.
+     * @return True if successful, false otherwise.
+     */
+    bool checkpoint();
+
+    /**
+     * @brief Gets the number of replaced tables and blocks not yet freed.
+     * @return Number of retired versions some reader may still see.
+     */
+    size_t retiredVersions() const;
+
+    /**
+     * @brief Gets the number of blocks in the current snapshot.
+     * @return Number of blocks.
+     */
+    size_t blockCount() const;
+
+private:
+    /**
+     * @brief One immutable version of the block table.
+     */
+    struct BlockTable {
+        std::map<int, const Block*> blocks;            ///< Block versions by RBN
+        std::shared_ptr<const std::map<int, int>> index;  ///< Zip code to RBN, shared between versions
+    };
+
+    std::atomic<const BlockTable*> current;  ///< Table seen by new readers
+    mutable EpochManager epochs;             ///< Reclaims replaced tables and blocks
+    std::mutex writerLatch;                  ///< Serializes writers
+    std::unique_ptr<WriteAheadLog> log;      ///< Redo log, if updates are logged
+    std::string blockPath;                   ///< Block file given to `open`, if any
+    int headRBN;                             ///< Head of the active list of that file
+
+    void publish(BlockTable* next);
+    bool checkpointLocked();
+};
+
+#endif // SNAPSHOT_SET_H
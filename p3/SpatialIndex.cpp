@@ -0,0 +1,207 @@
+#include "SpatialIndex.h"
+#include "GeoKernel.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * @brief Converts degrees to radians.
+ *
+ * @param degrees Angle in degrees.
+ * @return Angle in radians.
+ */
+static double toRadians(double degrees) {
+    return degrees * M_PI / 180.0;
+}
+
+/**
+ * @brief Constructs an empty index.
+ *
+ * @param cellDegrees Side of a grid cell in degrees of latitude and longitude.
+ */
+SpatialIndex::SpatialIndex(double cellDegrees)
+    : cellDegrees(cellDegrees > 0 ? cellDegrees : 0.5), rows(0), columns(0) {}
+
+/**
+ * @brief Computes the great circle distance between two points.
+ *
+ * @param latitude1 Latitude of the first point in degrees.
+ * @param longitude1 Longitude of the first point in degrees.
+ * @param latitude2 Latitude of the second point in degrees.
+ * @param longitude2 Longitude of the second point in degrees.
+ * @return Distance in kilometers.
+ */
+double SpatialIndex::haversineKm(double latitude1, double longitude1, double latitude2, double longitude2) {
+    return ::haversineKm(latitude1, longitude1, latitude2, longitude2);
+}
+
+/**
+ * @brief Gets the grid row of a latitude.
+ *
+ * @param latitude Latitude in degrees.
+ * @return Row, clamped to the grid.
+ */
+int SpatialIndex::rowOf(double latitude) const {
+    double row = floor((latitude + 90.0) / cellDegrees);
+    return static_cast<int>(max(0.0, min(rows - 1.0, row)));
+}
+
+/**
+ * @brief Gets the grid column of a longitude.
+ *
+ * @param longitude Longitude in degrees; values outside [-180, 180) wrap around.
+ * @return Column in [0, columns).
+ */
+int SpatialIndex::columnOf(double longitude) const {
+    double wrapped = fmod(longitude + 180.0, 360.0);
+    if (wrapped < 0) wrapped += 360.0;
+    int column = static_cast<int>(floor(wrapped / cellDegrees));
+    return min(column, columns - 1);
+}
+
+/**
+ * @brief Builds the grid over a set of records, replacing any previous content.
+ *
+ * A counting sort places the records of each cell next to each other, so the
+ * grid costs one offset per cell on top of the records.
+ *
+ * @param source Records to index, for instance `Buffer::get_records()`.
+ */
+void SpatialIndex::build(const vector<ZipCodeRecord>& source) {
+    rows = static_cast<int>(ceil(180.0 / cellDegrees));
+    columns = static_cast<int>(ceil(360.0 / cellDegrees));
+    size_t cellCount = static_cast<size_t>(rows) * columns;
+
+    vector<size_t> cellOf(source.size());
+    cellStart.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < source.size(); i++) {
+        cellOf[i] = static_cast<size_t>(rowOf(source[i].latitude)) * columns + columnOf(source[i].longitude);
+        cellStart[cellOf[i] + 1]++;
+    }
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    vector<uint32_t> next(cellStart.begin(), cellStart.end() - 1);
+    records.assign(source.size(), ZipCodeRecord());
+    latitudes.assign(source.size(), 0.0);
+    longitudes.assign(source.size(), 0.0);
+    for (size_t i = 0; i < source.size(); i++) {
+        uint32_t slot = next[cellOf[i]]++;
+        records[slot] = source[i];
+        latitudes[slot] = source[i].latitude;
+        longitudes[slot] = source[i].longitude;
+    }
+}
+
+/**
+ * @brief Adds the records of one cell that lie within a radius of a point.
+ *
+ * The coordinates of a cell are contiguous, so the whole cell goes through the
+ * batch distance kernel at once.
+ *
+ * @param row Grid row of the cell.
+ * @param column Grid column of the cell.
+ * @param latitude Latitude of the point in degrees.
+ * @param longitude Longitude of the point in degrees.
+ * @param radiusKm Search radius in kilometers.
+ * @param distances Scratch space for the distances of the cell.
+ * @param matches Receives the records within the radius.
+ */
+void SpatialIndex::scanCell(int row, int column, double latitude, double longitude, double radiusKm,
+                            vector<double>& distances, vector<SpatialMatch>& matches) const {
+    size_t cell = static_cast<size_t>(row) * columns + column;
+    uint32_t first = cellStart[cell];
+    uint32_t count = cellStart[cell + 1] - first;
+    if (count == 0) {
+        return;
+    }
+    distances.resize(count);
+    haversineBatchKm(latitude, longitude, &latitudes[first], &longitudes[first], count, distances.data());
+    for (uint32_t i = 0; i < count; i++) {
+        if (distances[i] <= radiusKm) {
+            matches.push_back({&records[first + i], distances[i]});
+        }
+    }
+}
+
+/**
+ * @brief Finds every record within a distance of a point.
+ *
+ * Only the cells overlapping the bounding box of the search circle are scanned.
+ * The longitude half width of that box is asin(sin(d) / cos(latitude)) for an
+ * angular radius d; near a pole the box spans every longitude.
+ *
+ * @param latitude Latitude of the point in degrees.
+ * @param longitude Longitude of the point in degrees.
+ * @param radiusKm Search radius in kilometers.
+ * @return The matches ordered by increasing distance.
+ */
+vector<SpatialMatch> SpatialIndex::withinRadius(double latitude, double longitude, double radiusKm) const {
+    vector<SpatialMatch> matches;
+    if (records.empty() || radiusKm < 0) {
+        return matches;
+    }
+
+    double angle = radiusKm / EARTH_RADIUS_KM;  ///< Angular radius in radians
+    double angleDegrees = angle * 180.0 / M_PI;
+    double south = latitude - angleDegrees;
+    double north = latitude + angleDegrees;
+
+    int firstColumn = 0;
+    int columnSpan = columns;
+    double cosLatitude = cos(toRadians(latitude));
+    if (south > -90.0 && north < 90.0 && angle < M_PI / 2 && sin(angle) < cosLatitude) {
+        double halfWidth = asin(sin(angle) / cosLatitude) * 180.0 / M_PI;
+        firstColumn = columnOf(longitude - halfWidth);
+        int lastColumn = columnOf(longitude + halfWidth);
+        columnSpan = (lastColumn - firstColumn + columns) % columns + 1;
+        if (2 * halfWidth >= 360.0 - cellDegrees) {
+            columnSpan = columns;
+        }
+    }
+
+    vector<double> distances;
+    for (int row = rowOf(south); row <= rowOf(north); row++) {
+        for (int offset = 0; offset < columnSpan; offset++) {
+            scanCell(row, (firstColumn + offset) % columns, latitude, longitude, radiusKm, distances, matches);
+        }
+    }
+
+    sort(matches.begin(), matches.end(),
+         [](const SpatialMatch& a, const SpatialMatch& b) { return a.distanceKm < b.distanceKm; });
+    return matches;
+}
+
+/**
+ * @brief Finds the records closest to a point.
+ *
+ * The search radius starts at about one cell and doubles until the circle holds
+ * k records; every record outside the circle is farther than every record in it.
+ *
+ * @param latitude Latitude of the point in degrees.
+ * @param longitude Longitude of the point in degrees.
+ * @param k Number of records to return.
+ * @return Up to k matches ordered by increasing distance.
+ */
+vector<SpatialMatch> SpatialIndex::nearest(double latitude, double longitude, size_t k) const {
+    if (k == 0 || records.empty()) {
+        return {};
+    }
+
+    const double halfCircumference = M_PI * EARTH_RADIUS_KM;
+    double radiusKm = toRadians(cellDegrees) * EARTH_RADIUS_KM / 2;
+    vector<SpatialMatch> matches;
+    while (true) {
+        matches = withinRadius(latitude, longitude, radiusKm);
+        if (matches.size() >= k || radiusKm >= halfCircumference) {
+            break;
+        }
+        radiusKm = min(radiusKm * 2, halfCircumference);
+    }
+    if (matches.size() > k) {
+        matches.resize(k);
+    }
+    return matches;
+}
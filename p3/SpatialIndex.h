@@ -0,0 +1,97 @@
+/**
+ * @file SpatialIndex.h
+ * @brief Declaration of the uniform latitude/longitude grid over zip code records.
+ *
+ * The globe is cut into square cells of `cellDegrees` on a side. Records are
+ * sorted by cell, and each cell keeps the range of its records, so a query only
+ * measures the records of the cells that overlap its search circle. Longitudes
+ * wrap at the antimeridian, which keeps the Aleutians and Guam queries correct.
+ * Distances come from the batch kernels of GeoKernel.h.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Buffer.h"
+
+/**
+ * @brief A record found by a spatial query and its distance from the query point.
+ */
+struct SpatialMatch {
+    const ZipCodeRecord* record;  ///< Record held by the index
+    double distanceKm;            ///< Great circle distance from the query point
+};
+
+/**
+ * @class SpatialIndex
+ * @brief Uniform grid answering nearest and within-radius zip code queries.
+ */
+class SpatialIndex {
+public:
+    /**
+     * @brief Constructs an empty index.
+     * @param cellDegrees Side of a grid cell in degrees of latitude and longitude.
+     */
+    explicit SpatialIndex(double cellDegrees = 0.5);
+
+    /**
+     * @brief Builds the grid over a set of records, replacing any previous content.
+     * @param records Records to index, for instance `Buffer::get_records()`.
+     */
+    void build(const std::vector<ZipCodeRecord>& records);
+
+    /**
+     * @brief Finds the records closest to a point.
+     * @param latitude Latitude of the point in degrees.
+     * @param longitude Longitude of the point in degrees.
+     * @param k Number of records to return.
+     * @return Up to k matches ordered by increasing distance.
+     */
+    std::vector<SpatialMatch> nearest(double latitude, double longitude, size_t k) const;
+
+    /**
+     * @brief Finds every record within a distance of a point.
+     * @param latitude Latitude of the point in degrees.
+     * @param longitude Longitude of the point in degrees.
+     * @param radiusKm Search radius in kilometers.
+     * @return The matches ordered by increasing distance.
+     */
+    std::vector<SpatialMatch> withinRadius(double latitude, double longitude, double radiusKm) const;
+
+    /**
+     * @brief Gets the number of indexed records.
+     * @return Number of records.
+     */
+    size_t size() const { return records.size(); }
+
+    /**
+     * @brief Computes the great circle distance between two points.
+     * @param latitude1 Latitude of the first point in degrees.
+     * @param longitude1 Longitude of the first point in degrees.
+     * @param latitude2 Latitude of the second point in degrees.
+     * @param longitude2 Longitude of the second point in degrees.
+     * @return Distance in kilometers.
+     */
+    static double haversineKm(double latitude1, double longitude1, double latitude2, double longitude2);
+
+private:
+    double cellDegrees;                  ///< Side of a cell in degrees
+    int rows;                            ///< Cells from the south to the north pole
+    int columns;                         ///< Cells around the equator
+    std::vector<ZipCodeRecord> records;  ///< Records sorted by cell
+    std::vector<double> latitudes;       ///< Latitude of each record, in record order
+    std::vector<double> longitudes;      ///< Longitude of each record, in record order
+    std::vector<uint32_t> cellStart;     ///< First record of each cell; cell c spans [cellStart[c], cellStart[c + 1])
+
+    int rowOf(double latitude) const;
+    int columnOf(double longitude) const;
+    void scanCell(int row, int column, double latitude, double longitude, double radiusKm,
+                  std::vector<double>& distances, std::vector<SpatialMatch>& matches) const;
+};
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,159 @@
+#include "StateExtremes.h"
+#include "Block.h"
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Orders points by one coordinate, then by zip code.
+ *
+ * @param a First point.
+ * @param b Second point.
+ * @return True if a comes before b.
+ */
+bool StateExtremes::ByCoordinate::operator()(const ExtremePoint& a, const ExtremePoint& b) const {
+    double first = useLatitude ? a.latitude : a.longitude;
+    double second = useLatitude ? b.latitude : b.longitude;
+    if (first != second) {
+        return first < second;
+    }
+    long zipA = strtol(a.zip.c_str(), nullptr, 10);
+    long zipB = strtol(b.zip.c_str(), nullptr, 10);
+    return zipA != zipB ? zipA < zipB : a.zip < b.zip;
+}
+
+/**
+ * @brief Adds one record.
+ *
+ * @param state State of the record.
+ * @param point Zip code and coordinates of the record.
+ */
+void StateExtremes::add(const string& state, const ExtremePoint& point) {
+    StateSets& sets = byState[fieldStrings.intern(state)];
+    sets.byLongitude.insert(point);
+    sets.byLatitude.insert(point);
+}
+
+/**
+ * @brief Removes one record previously added.
+ *
+ * @param state State of the record.
+ * @param point Zip code and coordinates of the record.
+ * @return True if the record was found and removed, false otherwise.
+ */
+bool StateExtremes::remove(const string& state, const ExtremePoint& point) {
+    uint32_t id;
+    if (!fieldStrings.find(state, id)) {
+        return false;
+    }
+    auto found = byState.find(id);
+    if (found == byState.end()) {
+        return false;
+    }
+    StateSets& sets = found->second;
+    auto longitudeEntry = sets.byLongitude.find(point);
+    auto latitudeEntry = sets.byLatitude.find(point);
+    if (longitudeEntry == sets.byLongitude.end() || latitudeEntry == sets.byLatitude.end()) {
+        return false;
+    }
+    sets.byLongitude.erase(longitudeEntry);
+    sets.byLatitude.erase(latitudeEntry);
+    if (sets.byLongitude.empty()) {
+        byState.erase(found);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the state, zip code and coordinates of one record of a block.
+ *
+ * @param records Flat list of record fields.
+ * @param first Position of the record's first field.
+ * @param state Receives the state.
+ * @param point Receives the zip code and coordinates.
+ * @return True if the coordinates are numeric, false otherwise.
+ */
+bool StateExtremes::parseRecord(const vector<string>& records, size_t first, string& state, ExtremePoint& point) {
+    char* latitudeEnd = nullptr;
+    char* longitudeEnd = nullptr;
+    point.zip = records[first];
+    state = records[first + 2];
+    point.latitude = strtod(records[first + 4].c_str(), &latitudeEnd);
+    point.longitude = strtod(records[first + 5].c_str(), &longitudeEnd);
+    return latitudeEnd != records[first + 4].c_str() && longitudeEnd != records[first + 5].c_str();
+}
+
+/**
+ * @brief Adds every record of a block.
+ *
+ * @param records Flat list of record fields, `FIELDS_PER_RECORD` per record.
+ */
+void StateExtremes::addRecords(const vector<string>& records) {
+    string state;
+    ExtremePoint point;
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+        if (parseRecord(records, i, state, point)) {
+            add(state, point);
+        }
+    }
+}
+
+/**
+ * @brief Removes every record of a block.
+ *
+ * @param records Flat list of record fields, `FIELDS_PER_RECORD` per record.
+ */
+void StateExtremes::removeRecords(const vector<string>& records) {
+    string state;
+    ExtremePoint point;
+    for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+        if (parseRecord(records, i, state, point)) {
+            remove(state, point);
+        }
+    }
+}
+
+/**
+ * @brief Gets the extremes of a state.
+ *
+ * @param state Two letter state code.
+ * @param report Receives the four extreme zip codes.
+ * @return True if the state has records, false otherwise.
+ */
+bool StateExtremes::extremes(const string& state, StateExtremeReport& report) const {
+    uint32_t id;
+    if (!fieldStrings.find(state, id)) {
+        return false;
+    }
+    auto found = byState.find(id);
+    if (found == byState.end() || found->second.byLongitude.empty()) {
+        return false;
+    }
+    const StateSets& sets = found->second;
+    report.easternmost = *sets.byLongitude.begin();
+    report.southernmost = *sets.byLatitude.begin();
+
+    // The largest coordinate may be shared; take its smallest zip code
+    ExtremePoint west = *sets.byLongitude.rbegin();
+    ExtremePoint north = *sets.byLatitude.rbegin();
+    west.zip.clear();
+    north.zip.clear();
+    report.westernmost = *sets.byLongitude.lower_bound(west);
+    report.northernmost = *sets.byLatitude.lower_bound(north);
+    return true;
+}
+
+/**
+ * @brief Gets every state with records.
+ *
+ * @return State codes in alphabetical order.
+ */
+vector<string> StateExtremes::states() const {
+    vector<string> names;
+    for (const auto& entry : byState) {
+        names.emplace_back(fieldStrings.text(entry.first));
+    }
+    sort(names.begin(), names.end());
+    return names;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file StateExtremes.h
+ * @brief Declaration of the per-state extreme zip codes, maintained as records change.
+ *
+ * Each state keeps its records in two ordered multisets, one by longitude and
+ * one by latitude, so the easternmost, westernmost, northernmost and
+ * southernmost zip codes are the ends of the sets. Adding or removing a record
+ * costs O(log n), and reading the extremes of a state costs O(1) after the
+ * state lookup.
+ *
+ * States are grouped by their id in `fieldStrings`, so each update compares
+ * integers rather than state names.
+ *
+ * Directions follow the rest of the project: easternmost is the smallest
+ * longitude, westernmost the largest. Ties go to the smaller zip code.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef STATE_EXTREMES_H
+#define STATE_EXTREMES_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+
+/**
+ * @brief A zip code and its coordinates.
+ */
+struct ExtremePoint {
+    std::string zip;   ///< Zip code
+    double latitude;   ///< Latitude in degrees
+    double longitude;  ///< Longitude in degrees
+};
+
+/**
+ * @brief The four extreme zip codes of one state.
+ */
+struct StateExtremeReport {
+    ExtremePoint easternmost;   ///< Smallest longitude
+    ExtremePoint westernmost;   ///< Largest longitude
+    ExtremePoint northernmost;  ///< Largest latitude
+    ExtremePoint southernmost;  ///< Smallest latitude
+};
+
+/**
+ * @class StateExtremes
+ * @brief Ordered sets by latitude and longitude for every state.
+ */
+class StateExtremes {
+public:
+    /**
+     * @brief Adds one record.
+     * @param state State of the record.
+     * @param point Zip code and coordinates of the record.
+     */
+    void add(const std::string& state, const ExtremePoint& point);
+
+    /**
+     * @brief Removes one record previously added.
+     * @param state State of the record.
+     * @param point Zip code and coordinates of the record.
+     * @return True if the record was found and removed, false otherwise.
+     */
+    bool remove(const std::string& state, const ExtremePoint& point);
+
+    /**
+     * @brief Adds every record of a block.
+     * @param records Flat list of record fields, `FIELDS_PER_RECORD` per record.
+     */
+    void addRecords(const std::vector<std::string>& records);
+
+    /**
+     * @brief Removes every record of a block.
+     * @param records Flat list of record fields, `FIELDS_PER_RECORD` per record.
+     */
+    void removeRecords(const std::vector<std::string>& records);
+
+    /**
+     * @brief Gets the extremes of a state.
+     * @param state Two letter state code.
+     * @param report Receives the four extreme zip codes.
+     * @return True if the state has records, false otherwise.
+     */
+    bool extremes(const std::string& state, StateExtremeReport& report) const;
+
+    /**
+     * @brief Gets every state with records.
+     * @return State codes in alphabetical order.
+     */
+    std::vector<std::string> states() const;
+
+    /**
+     * @brief Removes every record.
+     */
+    void clear() { byState.clear(); }
+
+private:
+    /**
+     * @brief Orders points by one coordinate, then by zip code.
+     */
+    struct ByCoordinate {
+        bool useLatitude;  ///< True to order by latitude, false by longitude
+        bool operator()(const ExtremePoint& a, const ExtremePoint& b) const;
+    };
+
+    /**
+     * @brief Records of one state ordered both ways.
+     */
+    struct StateSets {
+        std::multiset<ExtremePoint, ByCoordinate> byLongitude{ByCoordinate{false}};
+        std::multiset<ExtremePoint, ByCoordinate> byLatitude{ByCoordinate{true}};
+    };
+
+    std::map<uint32_t, StateSets> byState;  ///< Records of every state, by id in `fieldStrings`
+
+    static bool parseRecord(const std::vector<std::string>& records, size_t first,
+                            std::string& state, ExtremePoint& point);
+};
+
+#endif // STATE_EXTREMES_H
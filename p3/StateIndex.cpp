@@ -0,0 +1,105 @@
+#include "StateIndex.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Adds a record to the index.
+ *
+ * @param state State of the record.
+ * @param zip Zip code of the record.
+ * @param RBN Block holding the record.
+ */
+void StateIndex::add(const string& state, int zip, int RBN) {
+    entries[state].push_back({zip, RBN});
+}
+
+/**
+ * @brief Writes the index to a file, sorting each state by zip code first.
+ *
+ * @param filename Path of the state index file.
+ * @return True if successful, false otherwise.
+ */
+bool StateIndex::save(const string& filename) {
+    ofstream out(filename);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open " << filename << endl;
+        return false;
+    }
+    for (auto& [state, records] : entries) {
+        sort(records.begin(), records.end(),
+             [](const StateEntry& a, const StateEntry& b) { return a.zip < b.zip; });
+        for (const StateEntry& record : records) {
+            out << state << " " << record.zip << " " << record.RBN << "\n";
+        }
+    }
+    return out.good();
+}
+
+/**
+ * @brief Reads an index written by `save`, replacing the current content.
+ *
+ * @param filename Path of the state index file.
+ * @return True if successful, false if the file is missing or malformed.
+ */
+bool StateIndex::load(const string& filename) {
+    ifstream in(filename);
+    if (!in.is_open()) {
+        return false;
+    }
+    entries.clear();
+    string state;
+    StateEntry record;
+    while (in >> state >> record.zip >> record.RBN) {
+        entries[state].push_back(record);
+    }
+    if (!in.eof()) {
+        cerr << "Error: Malformed state index file " << filename << endl;
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the records of a state.
+ *
+ * @param state Two letter state code.
+ * @return The records of the state sorted by zip code; empty if the state is unknown.
+ */
+const vector<StateEntry>& StateIndex::zipsIn(const string& state) const {
+    static const vector<StateEntry> none;
+    auto found = entries.find(state);
+    return found == entries.end() ? none : found->second;
+}
+
+/**
+ * @brief Gets the blocks holding the records of a state.
+ *
+ * @param state Two letter state code.
+ * @return Distinct RBNs in ascending order.
+ */
+vector<int> StateIndex::blocksIn(const string& state) const {
+    vector<int> RBNs;
+    for (const StateEntry& record : zipsIn(state)) {
+        RBNs.push_back(record.RBN);
+    }
+    sort(RBNs.begin(), RBNs.end());
+    RBNs.erase(unique(RBNs.begin(), RBNs.end()), RBNs.end());
+    return RBNs;
+}
+
+/**
+ * @brief Gets every state in the index.
+ *
+ * @return State codes in alphabetical order.
+ */
+vector<string> StateIndex::states() const {
+    vector<string> names;
+    for (const auto& entry : entries) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file StateIndex.h
+ * @brief Declaration of the secondary index from state to zip codes and blocks.
+ *
+ * `Index::processBlockData` builds it next to the primary index and saves it as
+ * `<index>.state`, one "state zip RBN" line per record sorted by state and zip.
+ * Listing the zip codes of a state is then a single lookup, and the blocks of a
+ * state can be read without scanning the rest of the file.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef STATE_INDEX_H
+#define STATE_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * @brief One record of a state: its zip code and the block holding it.
+ */
+struct StateEntry {
+    int zip;  ///< Zip code of the record
+    int RBN;  ///< Block holding the record
+};
+
+/**
+ * @class StateIndex
+ * @brief Maps each state to its zip codes in ascending order.
+ */
+class StateIndex {
+public:
+    /**
+     * @brief Adds a record to the index.
+     * @param state State of the record.
+     * @param zip Zip code of the record.
+     * @param RBN Block holding the record.
+     */
+    void add(const std::string& state, int zip, int RBN);
+
+    /**
+     * @brief Writes the index to a file, sorting each state by zip code first.
+     * @param filename Path of the state index file.
+     * @return True if successful, false otherwise.
+     */
+    bool save(const std::string& filename);
+
+    /**
+     * @brief Reads an index written by `save`, replacing the current content.
+     * @param filename Path of the state index file.
+     * @return True if successful, false if the file is missing or malformed.
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * @brief Gets the records of a state.
+     * @param state Two letter state code.
+     * @return The records of the state sorted by zip code; empty if the state is unknown.
+     */
+    const std::vector<StateEntry>& zipsIn(const std::string& state) const;
+
+    /**
+     * @brief Gets the blocks holding the records of a state.
+     * @param state Two letter state code.
+     * @return Distinct RBNs in ascending order.
+     */
+    std::vector<int> blocksIn(const std::string& state) const;
+
+    /**
+     * @brief Gets every state in the index.
+     * @return State codes in alphabetical order.
+     */
+    std::vector<std::string> states() const;
+
+private:
+    std::map<std::string, std::vector<StateEntry>> entries;  ///< Records of each state
+};
+
+#endif // STATE_INDEX_H
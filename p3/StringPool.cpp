@@ -0,0 +1,77 @@
+#include "StringPool.h"
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * @brief Constructs an empty pool.
+ */
+StringPool::StringPool() : ids(&storage) {}
+
+/**
+ * @brief Gets the id of a string, adding the string if it is new.
+ *
+ * @param text String to intern.
+ * @return Id of the string.
+ */
+uint32_t StringPool::intern(string_view text) {
+    {
+        shared_lock<shared_mutex> guard(latch);
+        auto found = ids.find(text);
+        if (found != ids.end()) {
+            return found->second;
+        }
+    }
+
+    unique_lock<shared_mutex> guard(latch);
+    auto found = ids.find(text);  // Another thread may have added it meanwhile
+    if (found != ids.end()) {
+        return found->second;
+    }
+    char* copy = static_cast<char*>(storage.allocate(text.size() + 1, 1));
+    memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    uint32_t id = static_cast<uint32_t>(values.size());
+    values.emplace_back(copy, text.size());
+    ids.emplace(values.back(), id);
+    return id;
+}
+
+/**
+ * @brief Looks up the id of a string without adding it.
+ *
+ * @param text String to look up.
+ * @param id Receives the id if the string is in the pool.
+ * @return True if the string is in the pool, false otherwise.
+ */
+bool StringPool::find(string_view text, uint32_t& id) const {
+    shared_lock<shared_mutex> guard(latch);
+    auto found = ids.find(text);
+    if (found == ids.end()) {
+        return false;
+    }
+    id = found->second;
+    return true;
+}
+
+/**
+ * @brief Gets the string with a given id.
+ *
+ * @param id Id returned by `intern`.
+ * @return The string, null terminated and valid for the life of the pool.
+ */
+string_view StringPool::text(uint32_t id) const {
+    shared_lock<shared_mutex> guard(latch);
+    return values[id];
+}
+
+/**
+ * @brief Gets the number of distinct strings.
+ *
+ * @return Number of strings; every id is below it.
+ */
+size_t StringPool::size() const {
+    shared_lock<shared_mutex> guard(latch);
+    return values.size();
+}
@@ -0,0 +1,74 @@
+/**
+ * @file StringPool.h
+ * @brief Declaration of the interning table for repeated field values.
+ *
+ * Only about 60 states and a few thousand city names occur across 40k
+ * records, so secondary structures keep a 32-bit id (or a view of the single
+ * stored copy) instead of their own string. Equal values get equal ids, so
+ * grouping and equality tests compare integers. The table is shared by the
+ * whole process through `fieldStrings` in Block.h and may be used from several
+ * threads.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory_resource>
+#include <shared_mutex>
+#include <cstdint>
+
+/**
+ * @class StringPool
+ * @brief Maps each distinct string to a dense 32-bit id.
+ *
+ * Strings are copied once into a monotonic arena and never move, so the views
+ * returned by `text` stay valid for the life of the pool.
+ */
+class StringPool {
+public:
+    StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief Gets the id of a string, adding the string if it is new.
+     * @param text String to intern.
+     * @return Id of the string.
+     */
+    uint32_t intern(std::string_view text);
+
+    /**
+     * @brief Looks up the id of a string without adding it.
+     * @param text String to look up.
+     * @param id Receives the id if the string is in the pool.
+     * @return True if the string is in the pool, false otherwise.
+     */
+    bool find(std::string_view text, uint32_t& id) const;
+
+    /**
+     * @brief Gets the string with a given id.
+     * @param id Id returned by `intern`.
+     * @return The string, null terminated and valid for the life of the pool.
+     */
+    std::string_view text(uint32_t id) const;
+
+    /**
+     * @brief Gets the number of distinct strings.
+     * @return Number of strings; every id is below it.
+     */
+    size_t size() const;
+
+private:
+    std::pmr::monotonic_buffer_resource storage;              ///< Text and hash nodes
+    std::vector<std::string_view> values;                     ///< Strings by id, viewing `storage`
+    std::pmr::unordered_map<std::string_view, uint32_t> ids;  ///< Views into `storage`, to their ids
+    mutable std::shared_mutex latch;                          ///< Shared for lookups, exclusive to add
+};
+
+#endif // STRING_POOL_H
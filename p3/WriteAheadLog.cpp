@@ -0,0 +1,218 @@
+#include "WriteAheadLog.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Computes the 32-bit FNV-1a checksum of a log entry.
+ *
+ * @param data Bytes covered by the checksum.
+ * @return The checksum value.
+ */
+static unsigned int entryChecksum(const string& data) {
+    unsigned int hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Opens (or creates) a log file for appending.
+ *
+ * Existing entries are kept so that a log which has not been checkpointed yet
+ * continues with the next sequence number.
+ *
+ * @param logFile Path to the log file.
+ * @param fsyncBatchSize Number of appended entries that share one fsync.
+ */
+WriteAheadLog::WriteAheadLog(const string& logFile, size_t fsyncBatchSize)
+    : path(logFile)
+    , fd(-1)
+    , batchSize(fsyncBatchSize == 0 ? 1 : fsyncBatchSize)
+    , pendingCount(0)
+    , nextLSN(1) {
+    long validBytes = 0;
+    nextLSN += replay(path, [](int, const string&) {}, &validBytes);
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) {
+        cerr << "Error: Could not open log file: " << path << endl;
+        return;
+    }
+
+    // Cut off a torn tail so that new entries do not get glued onto it
+    if (::ftruncate(fd, validBytes) != 0) {
+        cerr << "Error: Could not repair log file: " << path << endl;
+    }
+}
+
+/**
+ * @brief Syncs any unsynced entries and closes the log.
+ */
+WriteAheadLog::~WriteAheadLog() {
+    if (fd >= 0) {
+        sync();
+        ::close(fd);
+    }
+}
+
+/**
+ * @brief Appends the full image of a block to the log.
+ *
+ * The entry reaches the log file before this returns, so a committed update is
+ * never held only in the memory of the process.
+ *
+ * @param RBN Relative Block Number of the updated block.
+ * @param payload Comma separated records of the block.
+ * @return The log sequence number assigned to the entry, or 0 on failure.
+ */
+unsigned long WriteAheadLog::append(int RBN, const string& payload) {
+    lock_guard<mutex> guard(latch);
+    if (fd < 0) {
+        return 0;
+    }
+
+    unsigned long lsn = nextLSN++;
+    string body = to_string(lsn) + " " + to_string(RBN) + " " + payload;
+
+    stringstream entry;
+    entry << lsn << " " << RBN << " "
+          << hex << setw(8) << setfill('0') << entryChecksum(body) << dec
+          << " " << payload << "\n";
+
+    const string text = entry.str();
+    const char* data = text.data();
+    size_t remaining = text.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            cerr << "Error: Could not write to log file: " << path << endl;
+            return 0;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (++pendingCount >= batchSize && !syncLocked()) {
+        return 0;
+    }
+    return lsn;
+}
+
+/**
+ * @brief Forces every written entry to stable storage.
+ * @return True if successful, false otherwise.
+ */
+bool WriteAheadLog::sync() {
+    lock_guard<mutex> guard(latch);
+    return syncLocked();
+}
+
+/**
+ * @brief Performs the group commit; the caller must hold the latch.
+ * @return True if successful, false otherwise.
+ */
+bool WriteAheadLog::syncLocked() {
+    if (fd < 0) {
+        return false;
+    }
+    if (pendingCount == 0) {
+        return true;
+    }
+    if (::fsync(fd) != 0) {
+        cerr << "Error: Could not sync log file: " << path << endl;
+        return false;
+    }
+    pendingCount = 0;
+    return true;
+}
+
+/**
+ * @brief Discards the log contents after a successful checkpoint.
+ * @return True if successful, false otherwise.
+ */
+bool WriteAheadLog::truncate() {
+    lock_guard<mutex> guard(latch);
+    if (fd < 0) {
+        return false;
+    }
+    pendingCount = 0;
+    nextLSN = 1;
+    return ::ftruncate(fd, 0) == 0 && ::fsync(fd) == 0;
+}
+
+/**
+ * @brief Gets the number of written entries waiting for the next fsync.
+ * @return Number of unsynced entries.
+ */
+size_t WriteAheadLog::pendingEntries() const {
+    lock_guard<mutex> guard(latch);
+    return pendingCount;
+}
+
+/**
+ * @brief Replays every intact entry of a log file in order.
+ *
+ * @param logFile Path to the log file.
+ * @param apply Callback invoked with the RBN and payload of each entry.
+ * @param validBytes Optional output receiving the length of the intact prefix of the log.
+ * @return Number of entries replayed.
+ */
+size_t WriteAheadLog::replay(const string& logFile,
+                             const function<void(int, const string&)>& apply,
+                             long* validBytes) {
+    if (validBytes) {
+        *validBytes = 0;
+    }
+
+    ifstream inFile(logFile);
+    if (!inFile.is_open()) {
+        return 0;
+    }
+
+    size_t replayed = 0;
+    string line;
+    while (getline(inFile, line)) {
+        // A crash can leave the last entry without its terminating newline
+        if (inFile.eof()) {
+            break;
+        }
+
+        size_t first = line.find(' ');
+        size_t second = (first == string::npos) ? first : line.find(' ', first + 1);
+        size_t third = (second == string::npos) ? second : line.find(' ', second + 1);
+        if (third == string::npos || third - second != 9) {
+            break;
+        }
+
+        string lsn = line.substr(0, first);
+        string rbn = line.substr(first + 1, second - first - 1);
+        string payload = line.substr(third + 1);
+        int RBN;
+        try {
+            unsigned int stored = static_cast<unsigned int>(stoul(line.substr(second + 1, 8), nullptr, 16));
+            if (stored != entryChecksum(lsn + " " + rbn + " " + payload)) {
+                break;
+            }
+            RBN = stoi(rbn);
+        }
+        catch (const exception&) {
+            break;
+        }
+
+        apply(RBN, payload);
+        replayed++;
+        if (validBytes) {
+            *validBytes += static_cast<long>(line.size()) + 1;
+        }
+    }
+
+    inFile.close();
+    return replayed;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file WriteAheadLog.h
+ * @brief Declaration of the append-only redo log used for crash-safe block updates.
+ *
+ * Every block mutation is first appended to the log as a full block image. Each entry
+ * is written to the log file before `append` returns, so it survives the process being
+ * killed; the fsync that makes entries survive a power loss is shared by a configurable
+ * number of entries (group commit). On open, the log is replayed on top of the block
+ * file so that committed mutations survive a crash without a rebuild.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <string>
+#include <functional>
+#include <mutex>
+
+/**
+ * @class WriteAheadLog
+ * @brief Append-only redo log of block images with group commit.
+ *
+ * Each entry is one text line of the form `<LSN> <RBN> <checksum> <payload>`, where the
+ * payload is the comma separated record list of the block, exactly as it appears in the
+ * block file. A torn or corrupted tail is detected through the checksum and ignored.
+ */
+class WriteAheadLog {
+public:
+    /**
+     * @brief Opens (or creates) a log file for appending.
+     * @param logFile Path to the log file.
+     * @param fsyncBatchSize Number of appended entries that share one fsync.
+     */
+    WriteAheadLog(const std::string& logFile, size_t fsyncBatchSize = 32);
+
+    /**
+     * @brief Syncs any unsynced entries and closes the log.
+     */
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Checks whether the log file was opened successfully.
+     * @return True if the log can be appended to, false otherwise.
+     */
+    bool isOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Appends the full image of a block to the log.
+     *
+     * The entry is written to the log file right away; once `fsyncBatchSize`
+     * entries have been written since the last fsync, they are synced together.
+     *
+     * @param RBN Relative Block Number of the updated block.
+     * @param payload Comma separated records of the block.
+     * @return The log sequence number assigned to the entry, or 0 on failure.
+     */
+    unsigned long append(int RBN, const std::string& payload);
+
+    /**
+     * @brief Forces every written entry to stable storage.
+     * @return True if successful, false otherwise.
+     */
+    bool sync();
+
+    /**
+     * @brief Discards the log contents after a successful checkpoint.
+     * @return True if successful, false otherwise.
+     */
+    bool truncate();
+
+    /**
+     * @brief Gets the number of written entries waiting for the next fsync.
+     * @return Number of unsynced entries.
+     */
+    size_t pendingEntries() const;
+
+    /**
+     * @brief Replays every intact entry of a log file in order.
+     *
+     * Replay stops at the first partial or corrupted entry, which is the torn tail
+     * left behind by a crash in the middle of a write.
+     *
+     * @param logFile Path to the log file.
+     * @param apply Callback invoked with the RBN and payload of each entry.
+     * @param validBytes Optional output receiving the length of the intact prefix of the log.
+     * @return Number of entries replayed.
+     */
+    static size_t replay(const std::string& logFile,
+                         const std::function<void(int, const std::string&)>& apply,
+                         long* validBytes = nullptr);
+
+private:
+    std::string path;          ///< Path of the log file
+    int fd;                    ///< File descriptor opened in append mode
+    size_t batchSize;          ///< Entries per group commit
+    size_t pendingCount;       ///< Entries written since the last fsync
+    unsigned long nextLSN;     ///< Sequence number of the next entry
+    mutable std::mutex latch;  ///< Serializes appenders sharing the log
+
+    bool syncLocked();
+};
+
+#endif // WRITE_AHEAD_LOG_H
@@ -0,0 +1,153 @@
+/**
+ * @file AllocationAudit.cpp
+ * @brief Counts heap allocations on the load paths and checks them against budgets.
+ *
+ * Replaces the global operator new with a counting version, runs each load
+ * path once, and prints the allocations per record next to its budget. The
+ * program exits with status 1 if any path goes over its budget, so a change
+ * that reintroduces a copy on these paths is caught by running it. Budgets
+ * are set for us_postal_codes.csv, where most fields fit in the small string
+ * buffer and only long city names allocate.
+ *
+ * The block file is built from the CSV file first unless it already was, so
+ * the audit never depends on a block file left behind by another program.
+ *
+ * Build and run from the p3 directory, next to the CSV file:
+ *     g++ -std=c++17 -O2 -I. bench/AllocationAudit.cpp $(ls *.cpp | grep -v main.cpp) -o alloc_audit
+ *     ./alloc_audit [us_postal_codes.csv] [block.txt]
+ *
+ * The top level CMake build also builds it as the `alloc_audit` target and
+ * registers it with CTest, so `ctest` fails when a budget is exceeded.
+ *
+ * @date 10/18/2026
+ */
+
+#include "Block.h"
+#include "Buffer.h"
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Number of calls to the global operator new since the program started.
+ */
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+/**
+ * @brief Prints one measurement and checks it against its budget.
+ *
+ * @param name Load path measured.
+ * @param allocations Allocations made by the path.
+ * @param records Records handled by the path.
+ * @param budget Largest allowed allocations per record.
+ * @return True if the path is within its budget, false otherwise.
+ */
+static bool report(const string& name, size_t allocations, size_t records, double budget) {
+    double perRecord = records ? static_cast<double>(allocations) / records : static_cast<double>(allocations);
+    bool within = perRecord <= budget;
+    cout << left << setw(34) << name << right << setw(10) << allocations << " allocations "
+         << setw(8) << fixed << setprecision(2) << perRecord << " per record (budget "
+         << budget << ")" << (within ? "" : "  OVER BUDGET") << "\n";
+    return within;
+}
+
+int main(int argc, char* argv[]) {
+    string csvFile = argc > 1 ? argv[1] : "us_postal_codes.csv";
+    string blockFile = argc > 2 ? argv[2] : "block.txt";
+    bool ok = true;
+
+    // Built before anything is counted; only the load paths are measured
+    if (!blockFileMatchesSource(blockFile, csvFile) && !createBlockFile(csvFile, blockFile)) {
+        cerr << "Error: Could not build " << blockFile << " from " << csvFile << endl;
+        return 1;
+    }
+
+    // CSV into the p3 Buffer: the record itself plus its copy in the block map
+    {
+        Buffer buffer;
+        size_t before = allocationCount;
+        if (!buffer.read_csv(csvFile, 512)) {
+            return 1;
+        }
+        size_t records = buffer.get_records().size();
+        ok &= report("Buffer::read_csv", allocationCount - before, records, 2.5);
+
+        before = allocationCount;
+        buffer.get_blocks();
+        ok &= report("Buffer::get_blocks", allocationCount - before, records, 0.0);
+    }
+
+    // Block file into a block table, then every block decoded
+    map<int, Block> table;
+    size_t records = 0;
+    {
+        size_t before = allocationCount;
+        if (loadBlockFile(blockFile, table) == -1) {
+            return 1;
+        }
+        for (auto& [RBN, block] : table) {
+            materializeBlock(block);
+            records += block.records.size() / FIELDS_PER_RECORD;
+        }
+        ok &= report("loadBlockFile + materializeBlock", allocationCount - before, records, 1.0);
+    }
+
+    // Records of every block split out of and joined back into payloads
+    {
+        vector<string> payloads;
+        for (const auto& [RBN, block] : table) {
+            payloads.push_back(joinRecords(block.records));
+        }
+        size_t before = allocationCount;
+        for (const string& payload : payloads) {
+            vector<string> fields = splitRecords(payload);
+        }
+        ok &= report("splitRecords", allocationCount - before, records, 0.5);
+    }
+
+    // Blocks installed in the global table
+    {
+        vector<vector<string>> images;
+        for (const auto& [RBN, block] : table) {
+            images.push_back(block.records);
+        }
+        size_t before = allocationCount;
+        int RBN = 0;
+        for (vector<string>& image : images) {
+            createBlock(RBN, false, move(image), RBN - 1, RBN + 1);
+            RBN++;
+        }
+        ok &= report("createBlock", allocationCount - before, records, 0.5);
+
+        before = allocationCount;
+        for (int i = 0; i < RBN; i++) {
+            getBlockByRBN(i);
+        }
+        ok &= report("getBlockByRBN", allocationCount - before, records, 0.0);
+    }
+
+    cout << (ok ? "All load paths are within budget.\n" : "Some load paths are over budget.\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file GeoKernelBench.cpp
+ * @brief Microbenchmark of the scalar and AVX2 great circle distance kernels.
+ *
+ * Measures one query point against every zip code of the CSV file, first with
+ * the distance kernel and then with the radius filter, on each supported path.
+ * It also reports the largest difference between the AVX2 and scalar distances.
+ *
+ * Build and run from the p3 directory:
+ *     g++ -std=c++17 -O2 -I. bench/GeoKernelBench.cpp GeoKernel.cpp Buffer.cpp -o geo_bench
+ *     ./geo_bench [us_postal_codes.csv] [queries]
+ *
+ * The top level CMake build also builds it as the `geo_bench` target.
+ *
+ * @date 10/18/2026
+ */
+
+#include "GeoKernel.h"
+#include "Buffer.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Times one kernel over every query point.
+ *
+ * @param queries Number of query points, taken from the records.
+ * @param latitudes Latitudes of all records.
+ * @param longitudes Longitudes of all records.
+ * @param kernel Callback running the kernel for one query point.
+ * @return Nanoseconds per measured point.
+ */
+template <typename Kernel>
+static double timeKernel(size_t queries, const vector<double>& latitudes, const vector<double>& longitudes,
+                         Kernel kernel) {
+    auto start = chrono::steady_clock::now();
+    for (size_t q = 0; q < queries; q++) {
+        size_t point = (q * 7919) % latitudes.size();
+        kernel(latitudes[point], longitudes[point]);
+    }
+    chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(queries) * latitudes.size());
+}
+
+/**
+ * @brief Runs the benchmark.
+ *
+ * @param argc Argument count.
+ * @param argv Optional CSV file name and number of query points.
+ * @return 0 if successful, 1 if the CSV file could not be read.
+ */
+int main(int argc, char* argv[]) {
+    string csvFile = argc > 1 ? argv[1] : "us_postal_codes.csv";
+    size_t queries = argc > 2 ? stoul(argv[2]) : 200;
+
+    Buffer buffer;
+    if (!buffer.read_csv(csvFile, 512)) {
+        return 1;
+    }
+    vector<double> latitudes, longitudes;
+    for (const ZipCodeRecord& record : buffer.get_records()) {
+        latitudes.push_back(record.latitude);
+        longitudes.push_back(record.longitude);
+    }
+    size_t count = latitudes.size();
+    vector<double> distances(count), reference(count);
+    vector<uint32_t> hits(count);
+    double checksum = 0;
+
+    cout << count << " points, " << queries << " queries\n";
+    cout << left << setw(8) << "path" << setw(18) << "distance ns/pt" << setw(18) << "radius ns/pt" << "\n";
+
+    vector<GeoKernelPath> paths = {GeoKernelPath::Scalar, GeoKernelPath::AVX2};
+    for (GeoKernelPath path : paths) {
+        if (!setGeoKernelPath(path)) {
+            cout << setw(8) << geoKernelName(path) << "not supported on this processor\n";
+            continue;
+        }
+        double distanceTime = timeKernel(queries, latitudes, longitudes, [&](double latitude, double longitude) {
+            haversineBatchKm(latitude, longitude, latitudes.data(), longitudes.data(), count, distances.data());
+            checksum += distances[count / 2];
+        });
+        double radiusTime = timeKernel(queries, latitudes, longitudes, [&](double latitude, double longitude) {
+            checksum += radiusFilter(latitude, longitude, latitudes.data(), longitudes.data(), count, 50.0, hits.data());
+        });
+        cout << setw(8) << geoKernelName(path) << setw(18) << fixed << setprecision(3) << distanceTime
+             << setw(18) << radiusTime << "\n";
+    }
+
+    // Accuracy of the AVX2 kernel against the scalar one from a few query points
+    if (setGeoKernelPath(GeoKernelPath::AVX2)) {
+        double worst = 0;
+        for (size_t q = 0; q < 20; q++) {
+            size_t point = (q * 7919) % count;
+            setGeoKernelPath(GeoKernelPath::Scalar);
+            haversineBatchKm(latitudes[point], longitudes[point], latitudes.data(), longitudes.data(), count,
+                             reference.data());
+            setGeoKernelPath(GeoKernelPath::AVX2);
+            haversineBatchKm(latitudes[point], longitudes[point], latitudes.data(), longitudes.data(), count,
+                             distances.data());
+            for (size_t i = 0; i < count; i++) {
+                worst = max(worst, fabs(distances[i] - reference[i]));
+            }
+        }
+        cout << "largest avx2 - scalar difference: " << scientific << worst << " km\n";
+    }
+    cout << "(checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file IoBench.cpp
+ * @brief Throughput of the p3 I/O paths on 1x, 10x and 100x datasets.
+ *
+ * Covers Buffer::read_csv, createBlockFile, parseBlockFile,
+ * Index::processBlockData, search and listMost. Each dataset gets its own
+ * directory under the work directory holding its block file and index,
+ * because search reads `block.txt` from the current directory. Built and run
+ * by the `bench` target of the top level CMake build:
+ *     cmake -S . -B build && cmake --build build --target bench
+ *
+ * Or directly, with a subset of the scales:
+ *     ./build/p3/p3_io_bench --data=p3/us_postal_codes.csv --scales=1,10
+ *
+ * @date 10/18/2026
+ */
+
+#include "BenchHarness.h"
+#include "Block.h"
+#include "Buffer.h"
+#include "Index.h"
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Number of zip codes looked up by one iteration of the search case.
+ */
+static const size_t SEARCH_QUERIES = 16;
+
+/**
+ * @brief Turns a path into an absolute one, so it survives changes of directory.
+ *
+ * @param path Existing file or directory.
+ * @return The absolute path, or `path` itself if it cannot be resolved.
+ */
+static string absolutePath(const string& path) {
+    char resolved[PATH_MAX];
+    return realpath(path.c_str(), resolved) ? string(resolved) : path;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, options)) {
+        return 1;
+    }
+    string source = absolutePath(options.dataFile);
+    string workDir = absolutePath(options.workDir);
+    BenchRunner runner(options);
+
+    for (int scale : options.scales) {
+        string tag = "/" + to_string(scale) + "x";
+        string csvFile = workDir + "/us_postal_codes_" + to_string(scale) + "x.csv";
+        string dir = workDir + "/p3_" + to_string(scale) + "x";
+        size_t records = 0;
+        if (!makeScaledCsv(source, csvFile, scale, records)) {
+            return 1;
+        }
+        mkdir(dir.c_str(), 0755);
+        if (chdir(dir.c_str()) != 0) {
+            cerr << "Error: Could not enter " << dir << endl;
+            return 1;
+        }
+        string blockFile = dir + "/block.txt";
+        string indexFile = dir + "/index.idx";  // Distinct per dataset: search caches filters by name
+        size_t csvBytes = fileBytes(csvFile);
+
+        runner.run("Buffer::read_csv" + tag, records, csvBytes, [&] {
+            Buffer buffer;
+            buffer.read_csv(csvFile, 512);
+        });
+
+        runner.run("createBlockFile" + tag, records, csvBytes, [&] {
+            createBlockFile(csvFile, blockFile);
+        });
+        if (fileBytes(blockFile) == 0) {
+            runner.prepare([&] { createBlockFile(csvFile, blockFile); });
+        }
+        size_t blockBytes = fileBytes(blockFile);
+
+        runner.run("parseBlockFile" + tag, records, blockBytes, [&] {
+            parseBlockFile(blockFile);
+        }, clearBlocks);
+
+        runner.run("Index::processBlockData" + tag, records, blockBytes, [&] {
+            Index index;
+            index.processBlockData(blockFile, indexFile);
+        });
+        if (fileBytes(indexFile) == 0) {
+            runner.prepare([&] {
+                Index index;
+                index.processBlockData(blockFile, indexFile);
+            });
+        }
+
+        // Zip codes spread over the whole file, all present
+        clearBlocks();
+        parseBlockFile(blockFile);
+        vector<string> queries;
+        size_t stride = records / SEARCH_QUERIES + 1;
+        size_t seen = 0;
+        for (const auto& entry : blocks) {
+            Block* block = getBlockByRBN(entry.first);
+            for (size_t i = 0; block && i + FIELDS_PER_RECORD <= block->records.size(); i += FIELDS_PER_RECORD) {
+                if (seen++ % stride == 0) {
+                    queries.push_back(block->records[i]);
+                }
+            }
+        }
+        runner.run("search" + tag, queries.size(), fileBytes(indexFile) * queries.size(), [&] {
+            for (const string& zip : queries) {
+                search(zip, indexFile);
+            }
+        });
+
+        runner.run("listMost" + tag, records, blockBytes, listMost, [&] {
+            clearBlocks();
+            parseBlockFile(blockFile);
+        });
+        clearBlocks();
+    }
+    return 0;
+}
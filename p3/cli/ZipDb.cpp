@@ -0,0 +1,330 @@
+/**
+ * @file ZipDb.cpp
+ * @brief Non-interactive driver running one batch job over prebuilt block and index files.
+ *
+ * `main.cpp` waits on a menu. zipdb builds block.txt and index.idx only
+ * when asked to, and otherwise opens the existing block file, runs one job
+ * and exits:
+ *
+ *     zipdb build    [--csv=us_postal_codes.csv] [--block=block.txt] [--index=index.idx]
+ *                    [--block-size=512] [--codec=none|dict] [--layout=zip|hilbert]
+ *     zipdb lookup   --zips-from=<file|-> [--block=block.txt]
+ *     zipdb extremes [--state=XX] [--block=block.txt]
+ *     zipdb range    --from=<zip> --to=<zip> [--block=block.txt]
+ *     zipdb verify   [--block=block.txt] [--threads=0]
+ *
+ * lookup, extremes and range check the checksum of every block they read;
+ * `--verify=sampled` checks one block in 16 and `--verify=off` none. verify
+ * checks the header and every block of the file on all hardware threads (or
+ * `--threads`), lists the corrupted blocks and exits with status 2 if any.
+ *
+ * Options may also be given as `--name value`. Results go to standard output
+ * as CSV rows in the fields of us_postal_codes.csv, through a 64 KiB buffer
+ * flushed only when full and at exit. Lookups are read and answered one line
+ * at a time, so any number of zip codes can be streamed through. Zip codes
+ * that are not found, and a summary, go to standard error.
+ *
+ * A block that fails its checksum is skipped and reported, and the other blocks
+ * are still searched.
+ *
+ * Exit status is 0 on success, 1 on a usage or file error, 2 if corruption was found.
+ *
+ * @date 10/18/2026
+ */
+
+#include "Block.h"
+#include "Index.h"
+#include "SequenceSet.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Prints the command summary.
+ *
+ * @param program Name the program was started as.
+ */
+static void usage(const string& program) {
+    cerr << "Usage:\n"
+         << "  " << program << " build    [--csv=us_postal_codes.csv] [--block=block.txt] [--index=index.idx]\n"
+         << "                 [--block-size=512] [--codec=none|dict] [--layout=zip|hilbert]\n"
+         << "  " << program << " lookup   --zips-from=<file|-> [--block=block.txt]\n"
+         << "  " << program << " extremes [--state=XX] [--block=block.txt]\n"
+         << "  " << program << " range    --from=<zip> --to=<zip> [--block=block.txt]\n"
+         << "  " << program << " verify   [--block=block.txt] [--threads=0]\n"
+         << "Read commands also take --verify=always|sampled|off.\n";
+}
+
+/**
+ * @brief Reads `--name=value` and `--name value` options.
+ *
+ * @param argc Argument count from main.
+ * @param argv Arguments from main; options start after the command.
+ * @param options Receives the options by name, without the dashes.
+ * @return True if every argument is an option with a value, false otherwise.
+ */
+static bool parseOptions(int argc, char* argv[], map<string, string>& options) {
+    for (int i = 2; i < argc; i++) {
+        string argument = argv[i];
+        if (argument.rfind("--", 0) != 0) {
+            cerr << "Unexpected argument " << argument << endl;
+            return false;
+        }
+        size_t equals = argument.find('=');
+        if (equals != string::npos) {
+            options[argument.substr(2, equals - 2)] = argument.substr(equals + 1);
+        } else if (i + 1 < argc) {
+            options[argument.substr(2)] = argv[++i];
+        } else {
+            cerr << "Missing value for " << argument << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets an option or its default.
+ *
+ * @param options Options read from the command line.
+ * @param name Option name, without the dashes.
+ * @param fallback Value used when the option is absent.
+ * @return The value of the option.
+ */
+static string option(const map<string, string>& options, const string& name, const string& fallback = "") {
+    auto found = options.find(name);
+    return found == options.end() ? fallback : found->second;
+}
+
+/**
+ * @brief Writes one record as a CSV row.
+ *
+ * @param out Stream to write to.
+ * @param fields The `FIELDS_PER_RECORD` fields of the record.
+ */
+static void writeRecord(ostream& out, const vector<string>& fields) {
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (i) out << ',';
+        out << fields[i];
+    }
+    out << '\n';
+}
+
+/**
+ * @brief Writes the block file and index of a CSV file.
+ *
+ * @param options Command line options.
+ * @return Exit status.
+ */
+static int build(const map<string, string>& options) {
+    string csvFile = option(options, "csv", "us_postal_codes.csv");
+    string blockFile = option(options, "block", "block.txt");
+    string indexFile = option(options, "index", "index.idx");
+    size_t blockSize = strtoul(option(options, "block-size", "512").c_str(), nullptr, 10);
+    if (blockSize == 0) {
+        cerr << "Invalid block size" << endl;
+        return 1;
+    }
+    // The name parsers fall back to the default, so a name that does not round trip is a typo
+    string codecOption = option(options, "codec", "none");
+    BlockCodec codec = codecFromName(codecOption);
+    if (codecName(codec) != codecOption) {
+        cerr << "Unknown codec " << codecOption << endl;
+        return 1;
+    }
+    string layoutOption = option(options, "layout", "zip");
+    BlockLayout layout = layoutFromName(layoutOption);
+    if (layoutName(layout) != layoutOption) {
+        cerr << "Unknown layout " << layoutOption << endl;
+        return 1;
+    }
+
+    if (!createBlockFile(csvFile, blockFile, blockSize, codec, layout)) {
+        return 1;
+    }
+    Index index;
+    index.processBlockData(blockFile, indexFile);
+    cerr << "Built " << blockFile << " and " << indexFile << " from " << csvFile << endl;
+    return 0;
+}
+
+/**
+ * @brief Looks up every zip code of a file, one per line or separated by blanks.
+ *
+ * @param set Opened sequence set.
+ * @param options Command line options.
+ * @return Exit status.
+ */
+static int lookup(const SequenceSet& set, const map<string, string>& options) {
+    string source = option(options, "zips-from");
+    if (source.empty()) {
+        cerr << "lookup needs --zips-from=<file|->" << endl;
+        return 1;
+    }
+    ifstream file;
+    if (source != "-") {
+        file.open(source);
+        if (!file.is_open()) {
+            cerr << "Error: Could not open " << source << endl;
+            return 1;
+        }
+    }
+    istream& in = source == "-" ? cin : file;
+
+    size_t found = 0, missing = 0;
+    string zip;
+    vector<string> fields;
+    while (in >> zip) {
+        if (set.search(zip, fields)) {
+            writeRecord(cout, fields);
+            found++;
+        } else {
+            cerr << zip << " was not found." << '\n';
+            missing++;
+        }
+    }
+    cerr << found << " found, " << missing << " not found." << endl;
+    return 0;
+}
+
+/**
+ * @brief Writes the easternmost, westernmost, northernmost and southernmost zip code of states.
+ *
+ * @param set Opened sequence set.
+ * @param options Command line options.
+ * @return Exit status.
+ */
+static int extremes(const SequenceSet& set, const map<string, string>& options) {
+    string state = option(options, "state");
+    vector<string> states = state.empty() ? set.states() : vector<string>{state};
+
+    cout << "State,Easternmost,Westernmost,Northernmost,Southernmost\n";
+    for (const string& name : states) {
+        StateExtremeReport report;
+        if (!set.stateExtremes(name, report)) {
+            cerr << name << " has no zip codes." << endl;
+            return 1;
+        }
+        cout << name << ',' << report.easternmost.zip << ',' << report.westernmost.zip << ','
+             << report.northernmost.zip << ',' << report.southernmost.zip << '\n';
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes every record whose zip code lies in a closed range, in zip code order.
+ *
+ * @param set Opened sequence set.
+ * @param options Command line options.
+ * @return Exit status.
+ */
+static int range(const SequenceSet& set, const map<string, string>& options) {
+    string from = option(options, "from");
+    string to = option(options, "to");
+    if (from.empty() || to.empty()) {
+        cerr << "range needs --from=<zip> and --to=<zip>" << endl;
+        return 1;
+    }
+    size_t visited = set.rangeScan(atoi(from.c_str()), atoi(to.c_str()),
+                                   [](const vector<string>& fields) { writeRecord(cout, fields); });
+    cerr << visited << " zip codes in range." << endl;
+    return 0;
+}
+
+/**
+ * @brief Checks the header and every block checksum of a block file.
+ *
+ * @param options Command line options.
+ * @return Exit status.
+ */
+static int verify(const map<string, string>& options) {
+    string blockFile = option(options, "block", "block.txt");
+    BlockFileReport report;
+    if (!verifyBlockFile(blockFile, static_cast<unsigned>(atoi(option(options, "threads", "0").c_str())), report)) {
+        cerr << "Error: Could not verify " << blockFile << endl;
+        return 1;
+    }
+    sort(report.corruptRBNs.begin(), report.corruptRBNs.end());
+    for (int RBN : report.corruptRBNs) {
+        cout << RBN << "\n";
+    }
+    cerr << report.blocks << " blocks checked, " << report.unchecked << " without a checksum, "
+         << report.corruptRBNs.size() << " corrupted, " << report.malformed << " malformed lines." << endl;
+    bool complete = report.blocks == report.expectedBlocks;
+    if (!complete) {
+        cerr << "The header records " << report.expectedBlocks << " blocks." << endl;
+    }
+    return report.corruptRBNs.empty() && report.malformed == 0 && complete ? 0 : 2;
+}
+
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    static char outputBuffer[1 << 16];
+    cout.rdbuf()->pubsetbuf(outputBuffer, sizeof(outputBuffer));
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    string command = argv[1];
+    map<string, string> options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (command == "build") {
+        return build(options);
+    }
+    if (command == "verify") {
+        int status = verify(options);
+        cout.flush();
+        return status;
+    }
+    if (command != "lookup" && command != "extremes" && command != "range") {
+        cerr << "Unknown command " << command << endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    BlockVerifyMode mode;
+    if (!blockVerifyModeFromName(option(options, "verify", "always"), mode)) {
+        cerr << "Unknown verify mode " << option(options, "verify") << endl;
+        return 1;
+    }
+    setBlockVerifyMode(mode);
+
+    // Read-only jobs open the existing block file; nothing is rebuilt or logged
+    string blockFile = option(options, "block", "block.txt");
+    SequenceSet set;
+    if (!set.open(blockFile, false)) {
+        cerr << "Error: Could not open " << blockFile << "; run `" << argv[0] << " build` to create it." << endl;
+        return 1;
+    }
+    // Corrupted blocks are left out; the job still answers from every other block
+    vector<int> corrupt = set.corruptBlocks();
+    if (!corrupt.empty()) {
+        cerr << "Error: " << corrupt.size() << " corrupted block(s) in " << blockFile << " were skipped (RBN";
+        for (int RBN : corrupt) {
+            cerr << ' ' << RBN;
+        }
+        cerr << "); their zip codes are reported as not found. Run `" << argv[0] << " verify` for details." << endl;
+    }
+
+    int status;
+    if (command == "lookup") {
+        status = lookup(set, options);
+    } else if (command == "extremes") {
+        status = extremes(set, options);
+    } else {
+        status = range(set, options);
+    }
+    cout.flush();
+    return status == 0 && !corrupt.empty() ? 2 : status;
+}
@@ -1,22 +1,58 @@
 #include "Block.h"
 #include "Index.h"
+#include "Buffer.h"
+#include "SpatialIndex.h"
+#include "StateIndex.h"
+#include "CityIndex.h"
+#include "Metrics.h"
 #include <iostream>
 #include <string>
+#include <sys/stat.h>
 
 using namespace std;
 
+/**
+ * @brief Checks whether the index files built from a block file are all present and newer than it.
+ * 
+ * @param blockFile Path to the block file.
+ * @param indexFile Path to the index file; its sidecars share this name.
+ * @return True if no index file needs rebuilding, false otherwise.
+ */
+static bool indexFilesCurrent(const string& blockFile, const string& indexFile) {
+    struct stat block;
+    if (stat(blockFile.c_str(), &block) != 0) {
+        return false;
+    }
+    for (const char* suffix : {"", ".bloom", ".bounds", ".state", ".city"}) {
+        struct stat index;
+        if (stat((indexFile + suffix).c_str(), &index) != 0 || index.st_mtim.tv_sec < block.st_mtim.tv_sec
+            || (index.st_mtim.tv_sec == block.st_mtim.tv_sec && index.st_mtim.tv_nsec < block.st_mtim.tv_nsec)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Main function to interactively manage blocks.
  * 
  * This function provides an interactive menu-driven interface for managing and querying blocks. 
  * It performs the following steps:
  * 
- * 1. Creates a block file from an input CSV file.
- * 2. Parses the block file to populate the global `blocks` map.
+ * 1. Creates a block file from an input CSV file, unless the header of the
+ *    existing block file shows it was built from the current CSV file.
+ * 2. Opens the block file to populate the global `blocks` map and replays the
+ *    redo log of block updates that were committed before the last shutdown.
+ *    Blocks are read on first use, and the index files are only rebuilt when
+ *    they are missing or older than the block file.
  * 3. Enters an infinite loop providing the user with the following options:
  *    - Dump all blocks in physical order.
  *    - Dump all blocks in logical order.
  *    - Query a specific block by its RBN.
+ *    - Find the zip codes nearest to a latitude and longitude.
+ *    - List the zip codes of a state through the state index.
+ *    - Find zip codes by the start of their city name.
+ *    - Show the counters and latency histograms of the hot paths.
  *    - Exit the program.
  * 
  * The user can query the details of a specific block by entering its RBN, including
@@ -24,22 +60,57 @@ using namespace std;
  * 
  * @return int Exit code. Returns 0 if successful.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // --metrics-json=<file> writes the metrics as JSON on exit; --verify sets when block checksums are checked
+    string metricsFile;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        BlockVerifyMode mode;
+        if (argument.rfind("--metrics-json=", 0) == 0) {
+            metricsFile = argument.substr(argument.find('=') + 1);
+        } else if (argument.rfind("--verify=", 0) == 0 && blockVerifyModeFromName(argument.substr(9), mode)) {
+            setBlockVerifyMode(mode);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--metrics-json=<file>] [--verify=always|sampled|off]\n";
+            return 1;
+        }
+    }
+
     string inputFile = "us_postal_codes.csv";
     string outputFile = "block.txt";
 
-    // Step 1: Create the block file from the input CSV
-    if (createBlockFile(inputFile, outputFile)) {
+    // Step 1: Create the block file from the input CSV, unless it is already up to date
+    bool rebuilt = !blockFileMatchesSource(outputFile, inputFile);
+    if (!rebuilt) {
+        cout << "Using existing block file " << outputFile << ".\n";
+    } else if (createBlockFile(inputFile, outputFile)) {
         cout << "Block file created successfully.\n";
     } else {
         cerr << "Failed to create block file.\n";
         return 1;
     }
 
+    // Step 2: Open the block file to populate the global blocks map
+    if (!openBlockFile(outputFile)) {
+        cerr << "Failed to open block file.\n";
+        return 1;
+    }
+    if (recoverBlockFile(outputFile) < 0) {
+        cerr << "Failed to recover block updates.\n";
+        return 1;
+    }
+    openBlockLog(outputFile);
+
     Index index;
-    index.processBlockData( outputFile, "index.idx" );
-    // Step 2: Parse the block file to populate the global blocks map
-    parseBlockFile(outputFile);
+    if (rebuilt || !indexFilesCurrent(outputFile, "index.idx")) {
+        index.processBlockData( outputFile, "index.idx" );
+    }
+
+    SpatialIndex grid;  // Built on first use of the location search
+    StateIndex states;
+    states.load("index.idx.state");
+    CityIndex cities;
+    cities.load("index.idx.city");
 
     // Step 3: Enter an infinite loop to provide a user menu
     while (true) {
@@ -49,12 +120,18 @@ int main() {
         cout << "3. Query a Block by RBN\n";
 		cout << "4. Get the most of each state.\n";
 		cout << "5. Search for several zip codes.\n";
-        cout << "6. Exit\n";
+        cout << "6. Find zip codes near a location.\n";
+        cout << "7. List the zip codes of a state.\n";
+        cout << "8. Find zip codes by city name.\n";
+        cout << "9. Show metrics.\n";
+        cout << "10. Exit\n";
 		
         cout << "Enter your choice: ";
 
         int choice;
-        cin >> choice;
+        if (!(cin >> choice)) {
+            choice = 10;  // End of input exits like the menu option
+        }
 
         switch (choice) {
             case 1:
@@ -72,8 +149,9 @@ int main() {
                 int RBN;
                 cin >> RBN;
 
-                if (blocks.find(RBN) != blocks.end()) {
-                    const Block& block = blocks[RBN];
+                const Block* found = blocks.count(RBN) ? getBlockByRBN(RBN) : nullptr;
+                if (found) {
+                    const Block& block = *found;
                     cout << "\nDetails of Block RBN " << RBN << ":\n";
                     cout << "Available: " << (block.isAvailable ? "Yes" : "No") << "\n";
                     cout << "Records: ";
@@ -106,7 +184,73 @@ int main() {
 		break;
 			}
 
-            case 6:{
+            case 6: {
+                if (grid.size() == 0) {
+                    Buffer buffer;
+                    if (!buffer.read_csv(inputFile, 512)) {
+                        break;
+                    }
+                    grid.build(buffer.get_records());
+                }
+                double latitude, longitude, radiusKm;
+                size_t count;
+                cout << "Enter the latitude and longitude: ";
+                cin >> latitude >> longitude;
+                cout << "Enter how many zip codes to list: ";
+                cin >> count;
+                cout << "Enter the search radius in km (0 for no limit): ";
+                cin >> radiusKm;
+
+                vector<SpatialMatch> matches = radiusKm > 0
+                    ? grid.withinRadius(latitude, longitude, radiusKm)
+                    : grid.nearest(latitude, longitude, count);
+                if (matches.size() > count) {
+                    matches.resize(count);
+                }
+                for (const SpatialMatch& match : matches) {
+                    cout << match.record->zip_code << " " << match.record->city << " "
+                         << match.record->state_id << " " << match.distanceKm << " km\n";
+                }
+                if (matches.empty()) {
+                    cout << "No zip codes found.\n";
+                }
+                break;
+            }
+
+            case 7: {
+                cout << "Enter the state code: ";
+                string state;
+                cin >> state;
+                const vector<StateEntry>& zips = states.zipsIn(state);
+                for (const StateEntry& entry : zips) {
+                    cout << entry.zip << " (block " << entry.RBN << ")\n";
+                }
+                cout << zips.size() << " zip codes in " << state << " across "
+                     << states.blocksIn(state).size() << " blocks.\n";
+                break;
+            }
+
+            case 8: {
+                cout << "Enter the start of the city name: ";
+                string prefix;
+                cin >> ws;
+                getline(cin, prefix);
+                for (const CityEntry* entry : cities.prefix(prefix, 20)) {
+                    cout << entry->zip << " " << entry->city << " " << entry->state << "\n";
+                }
+                break;
+            }
+
+            case 9:
+                cout << "\n----- Metrics -----\n";
+                Metrics::print(cout);
+                break;
+
+            case 10:{
+                flushBlockLog();
+                if (!metricsFile.empty()) {
+                    Metrics::writeJson(metricsFile);
+                }
                 cout << "Exiting the program. Goodbye!\n";
                 return 0;
 			}
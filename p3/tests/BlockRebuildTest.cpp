@@ -0,0 +1,85 @@
+/**
+ * @file BlockRebuildTest.cpp
+ * @brief Checks that rebuilding a block file discards the redo log of the old file.
+ *
+ * A block image left in `<block>.log` by the file being replaced must not be
+ * replayed onto the rebuilt file. The test first checks that such a log is
+ * replayed when the file is kept, then rebuilds over it.
+ *
+ *     block_rebuild_test <csv file> <scratch block file>
+ *
+ * @date 10/18/2026
+ */
+
+#include "Block.h"
+#include "HeaderRecord.h"
+#include "WriteAheadLog.h"
+#include "TestSupport.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Leaves a logged image of block 1 and a stale header behind, as a killed process would.
+ *
+ * @param blockFile Path to the block file.
+ * @param records Records of the logged image.
+ */
+static void leaveLoggedUpdate(const string& blockFile, const vector<string>& records) {
+    {
+        WriteAheadLog log(blockFile + ".log", 1);
+        CHECK(log.append(1, joinRecords(records)) != 0);
+    }
+    HeaderRecord header;
+    header.setStaleFlag(true);
+    CHECK(header.writeStaleFlag(blockFile));
+}
+
+/**
+ * @brief Opens a block file, replays its log, and gets the records of block 1.
+ *
+ * @param blockFile Path to the block file.
+ * @param replayed Receives the number of replayed log entries.
+ * @return Records of block 1, or none if it cannot be read.
+ */
+static vector<string> reopenBlockOne(const string& blockFile, int& replayed) {
+    clearBlocks();
+    CHECK(openBlockFile(blockFile));
+    replayed = recoverBlockFile(blockFile);
+    Block* block = getBlockByRBN(1);
+    return block ? block->records : vector<string>{};
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <csv file> <scratch block file>" << endl;
+        return 1;
+    }
+    string csvFile = argv[1];
+    string blockFile = argv[2];
+
+    CHECK(createBlockFile(csvFile, blockFile));
+    int replayed = 0;
+    vector<string> original = reopenBlockOne(blockFile, replayed);
+    CHECK(replayed == 0);
+    CHECK(!original.empty());
+    vector<string> changed = original;
+    changed[1] = "Logged Before Rebuild";
+
+    // Kept file: the logged image is redone
+    leaveLoggedUpdate(blockFile, changed);
+    CHECK(reopenBlockOne(blockFile, replayed) == changed);
+    CHECK(replayed == 1);
+
+    // Rebuilt file: the same kind of log is dropped with the old file
+    leaveLoggedUpdate(blockFile, changed);
+    CHECK(fileSize(blockFile + ".log") > 0);
+    clearBlocks();
+    CHECK(createBlockFile(csvFile, blockFile));
+    CHECK(fileSize(blockFile + ".log") <= 0);
+    CHECK(reopenBlockOne(blockFile, replayed) == original);
+    CHECK(replayed == 0);
+
+    return testResult("block_rebuild_test");
+}
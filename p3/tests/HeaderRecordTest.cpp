@@ -0,0 +1,161 @@
+/**
+ * @file HeaderRecordTest.cpp
+ * @brief Checks that the binary header round trips and that damaged headers are rejected.
+ *
+ * A header is written with every value set, read back and compared. Copies of
+ * the file with a flipped payload byte, a wrong magic and a wrong version
+ * (with its checksum fixed up) must then all fail to read.
+ *
+ *     header_record_test <scratch file>
+ *
+ * @date 10/18/2026
+ */
+
+#include "HeaderRecord.h"
+#include "Crc32c.h"
+#include "TestSupport.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Reads a whole file.
+ * @param path Path of the file.
+ * @return Bytes of the file.
+ */
+static string readBytes(const string& path) {
+    ifstream file(path, ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Replaces a file with the given bytes.
+ * @param path Path of the file.
+ * @param bytes New content of the file.
+ */
+static void writeBytes(const string& path, const string& bytes) {
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+/**
+ * @brief Stores the CRC-32C of a header at offset 16, computed with that field zero.
+ * @param bytes Header of HeaderRecord::HEADER_SIZE bytes.
+ */
+static void fixChecksum(string& bytes) {
+    memset(&bytes[16], 0, 4);
+    uint32_t crc = crc32c(0, bytes.data(), HeaderRecord::HEADER_SIZE);
+    for (int i = 0; i < 4; i++) {
+        bytes[16 + i] = static_cast<char>((crc >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Writes a damaged copy of a header and tries to read it.
+ * @param path Path of the scratch file.
+ * @param bytes Damaged header bytes.
+ * @return True if the header was accepted, false otherwise.
+ */
+static bool accepts(const string& path, const string& bytes) {
+    writeBytes(path, bytes);
+    HeaderRecord header;
+    return header.readHeader(path);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <scratch file>" << endl;
+        return 1;
+    }
+    string path = argv[1];
+
+    FileFingerprint fingerprint;
+    fingerprint.size = 1894997;
+    fingerprint.mtime = 1760745600123456789LL;
+    fingerprint.hash = 0x0123456789ABCDEFULL;
+
+    HeaderRecord written;
+    written.setFileStructureType("blocked sequence set");
+    written.setVersion("2.0");
+    written.setBlockSize(512);
+    written.setMinBlockCapacity(0.5);
+    written.setIndexFileName("index.idx");
+    written.setIndexSchema("zip:int,RBN:int");
+    written.setPrimaryKeyField(0);
+    written.setAvailListRBN(7);
+    written.setActiveListRBN(1);
+    written.setStaleFlag(true);
+    written.setBlockCodec("dict");
+    written.setBlockLayout("hilbert");
+    written.setSource("us_postal_codes.csv", fingerprint);
+    written.setRecordCount(40933);
+    written.setBlockCount(3731);
+    written.addField("zip", "int");
+    written.addField("city", "string");
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        CHECK(written.writeHeader(file));
+    }
+    CHECK(fileSize(path) == static_cast<long long>(HeaderRecord::HEADER_SIZE));
+
+    // Round trip: every value comes back as written
+    HeaderRecord read;
+    CHECK(read.readHeader(path));
+    CHECK(read.getHeaderSize() == HeaderRecord::HEADER_SIZE);
+    CHECK(read.getFileStructureType() == written.getFileStructureType());
+    CHECK(read.getVersion() == written.getVersion());
+    CHECK(read.getBlockSize() == 512);
+    CHECK(read.getMinBlockCapacity() == 0.5);
+    CHECK(read.getIndexFileName() == "index.idx");
+    CHECK(read.getIndexSchema() == "zip:int,RBN:int");
+    CHECK(read.getPrimaryKeyField() == 0);
+    CHECK(read.getAvailListRBN() == 7);
+    CHECK(read.getActiveListRBN() == 1);
+    CHECK(read.getStaleFlag());
+    CHECK(read.getBlockCodec() == "dict");
+    CHECK(read.getBlockLayout() == "hilbert");
+    CHECK(read.getSourceFile() == "us_postal_codes.csv");
+    CHECK(read.getSourceFingerprint() == fingerprint);
+    CHECK(read.getRecordCount() == 40933);
+    CHECK(read.getBlockCount() == 3731);
+    CHECK(read.getFields().size() == 2);
+    if (read.getFields().size() == 2) {
+        CHECK(read.getFields()[1].name == "city");
+        CHECK(read.getFields()[1].typeSchema == "string");
+    }
+
+    string good = readBytes(path);
+    CHECK(good.size() == HeaderRecord::HEADER_SIZE);
+    if (good.size() != HeaderRecord::HEADER_SIZE) {
+        return testResult("header_record_test");
+    }
+    CHECK(accepts(path, good));
+
+    // A flipped byte in the record count no longer matches the checksum
+    string corrupted = good;
+    corrupted[40] ^= 0x01;
+    CHECK(!accepts(path, corrupted));
+
+    // A wrong magic is rejected even with a valid checksum
+    string wrongMagic = good;
+    wrongMagic[0] = 'X';
+    fixChecksum(wrongMagic);
+    CHECK(!accepts(path, wrongMagic));
+
+    // So is a newer format version
+    string wrongVersion = good;
+    wrongVersion[8] = static_cast<char>(HeaderRecord::FORMAT_VERSION + 1);
+    fixChecksum(wrongVersion);
+    CHECK(!accepts(path, wrongVersion));
+
+    // The fixed-up checksum itself is computed the way the reader expects
+    string recomputed = good;
+    fixChecksum(recomputed);
+    CHECK(recomputed == good);
+
+    return testResult("header_record_test");
+}
@@ -0,0 +1,148 @@
+/**
+ * @file RedoLogTest.cpp
+ * @brief Checks that logged block updates survive SIGKILL and that group commit batches only the fsync.
+ *
+ * A child process logs updates with a batch size larger than the number of
+ * updates, so no fsync has happened, and kills itself. The parent then
+ * reopens the block file and checks that every update is replayed, the
+ * stale flag set by the first update is cleared, and the log is emptied.
+ *
+ *     redo_log_test <csv file> <scratch block file>
+ *
+ * @date 10/18/2026
+ */
+
+#include "Block.h"
+#include "HeaderRecord.h"
+#include "WriteAheadLog.h"
+#include "TestSupport.h"
+#include <csignal>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Number of blocks the killed process updates.
+ */
+static const int UPDATED_BLOCKS = 3;
+
+/**
+ * @brief Gets the records a block is updated to.
+ *
+ * @param records Records of the block in the block file.
+ * @param RBN Relative Block Number of the block.
+ * @return The records with the place name of the first record changed.
+ */
+static vector<string> updatedRecords(vector<string> records, int RBN) {
+    records[1] = "Updated Place " + to_string(RBN);
+    return records;
+}
+
+/**
+ * @brief Opens a block file into the global blocks and replays its log.
+ *
+ * @param blockFile Path to the block file.
+ * @return Number of replayed log entries, or -1 on failure.
+ */
+static int reopen(const string& blockFile) {
+    clearBlocks();
+    CHECK(openBlockFile(blockFile));
+    return recoverBlockFile(blockFile);
+}
+
+/**
+ * @brief Checks that appended entries are written at once and synced every `batchSize` entries.
+ *
+ * @param logFile Path of a scratch log file.
+ */
+static void checkGroupCommit(const string& logFile) {
+    remove(logFile.c_str());
+    {
+        WriteAheadLog log(logFile, 4);
+        CHECK(log.isOpen());
+        for (int i = 1; i <= 3; i++) {
+            CHECK(log.append(i, "payload") == static_cast<unsigned long>(i));
+        }
+        CHECK(log.pendingEntries() == 3);
+        CHECK(fileSize(logFile) > 0);  // Written before the fsync
+        CHECK(log.append(4, "payload") == 4);
+        CHECK(log.pendingEntries() == 0);
+        CHECK(log.append(5, "payload") == 5);
+        CHECK(log.pendingEntries() == 1);
+        CHECK(log.sync());
+        CHECK(log.pendingEntries() == 0);
+    }
+    {
+        WriteAheadLog log(logFile, 0);  // A batch of zero syncs every entry
+        CHECK(log.append(6, "payload") == 6);
+        CHECK(log.pendingEntries() == 0);
+    }
+    vector<int> replayed;
+    CHECK(WriteAheadLog::replay(logFile, [&](int RBN, const string&) { replayed.push_back(RBN); }) == 6);
+    CHECK(replayed == vector<int>({1, 2, 3, 4, 5, 6}));
+    remove(logFile.c_str());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <csv file> <scratch block file>" << endl;
+        return 1;
+    }
+    string csvFile = argv[1];
+    string blockFile = argv[2];
+
+    checkGroupCommit(blockFile + ".grouptest.log");
+
+    CHECK(createBlockFile(csvFile, blockFile));
+    pid_t child = fork();
+    if (child == 0) {
+        // Acknowledged updates, none of them synced, then killed without any cleanup
+        if (reopen(blockFile) != 0 || !openBlockLog(blockFile, 32)) {
+            _exit(1);
+        }
+        for (int RBN = 1; RBN <= UPDATED_BLOCKS; RBN++) {
+            Block* block = getBlockByRBN(RBN);
+            if (!block || !updateBlock(RBN, updatedRecords(block->records, RBN))) {
+                _exit(1);
+            }
+        }
+        raise(SIGKILL);
+        _exit(1);
+    }
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+    HeaderRecord header;
+    CHECK(header.readHeader(blockFile) && header.getStaleFlag());
+
+    // The original records, read without replaying the log
+    vector<vector<string>> original;
+    {
+        map<int, Block> table;
+        CHECK(loadBlockFile(blockFile, table) != -1);
+        for (int RBN = 1; RBN <= UPDATED_BLOCKS; RBN++) {
+            original.push_back(table[RBN].records);
+        }
+    }
+
+    CHECK(reopen(blockFile) == UPDATED_BLOCKS);
+    for (int RBN = 1; RBN <= UPDATED_BLOCKS; RBN++) {
+        Block* block = getBlockByRBN(RBN);
+        CHECK(block && block->records == updatedRecords(original[RBN - 1], RBN));
+    }
+    CHECK(header.readHeader(blockFile) && !header.getStaleFlag());
+    CHECK(fileSize(blockFile + ".log") == 0);
+
+    // The checkpoint wrote the updates into the block file itself
+    CHECK(reopen(blockFile) == 0);
+    Block* block = getBlockByRBN(UPDATED_BLOCKS);
+    CHECK(block && block->records == updatedRecords(original[UPDATED_BLOCKS - 1], UPDATED_BLOCKS));
+
+    return testResult("redo_log_test");
+}
@@ -0,0 +1,161 @@
+/**
+ * @file SequenceSetConcurrencyTest.cpp
+ * @brief Runs SequenceSet searches and range scans alongside block updates and checks every result.
+ *
+ * One writer keeps renaming the first record of most blocks, which keeps their
+ * keys; a second writer keeps adding and removing the last record of one block,
+ * which changes the index. Readers meanwhile look up every zip code and scan a
+ * range away from the changing block, and check that no record is lost, torn
+ * or out of order. Build with -DZIPDB_TSAN=ON to run it under ThreadSanitizer.
+ *
+ *     sequence_set_concurrency_test <csv file> <scratch block file>
+ *
+ * @date 10/18/2026
+ */
+
+#include "Block.h"
+#include "SequenceSet.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Blocks renamed by the first writer, from RBN 1 on.
+ */
+static const int RENAMED_BLOCKS = 40;
+
+/**
+ * @brief Block whose key set the second writer changes.
+ */
+static const int RESIZED_BLOCK = 50;
+
+/**
+ * @brief Updates made by each writer.
+ */
+static const int UPDATES = 2000;
+
+/**
+ * @brief Place name a renamed record alternates with.
+ */
+static const string RENAMED = "Renamed Place";
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <csv file> <scratch block file>" << endl;
+        return 1;
+    }
+    string csvFile = argv[1];
+    string blockFile = argv[2];
+
+    CHECK(createBlockFile(csvFile, blockFile));
+    map<int, Block> table;
+    CHECK(loadBlockFile(blockFile, table) != -1);
+    CHECK(table.size() > static_cast<size_t>(RESIZED_BLOCK + 10));
+
+    SequenceSet set;
+    CHECK(set.open(blockFile, false));
+
+    // Every record of the blocks touched by the test, and a range between them
+    map<string, vector<string>> expected;
+    string removedZip;
+    for (int RBN = 1; RBN <= RESIZED_BLOCK + 10; RBN++) {
+        materializeBlock(table[RBN]);
+        const vector<string>& records = table[RBN].records;
+        for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+            expected[records[i]].assign(records.begin() + i, records.begin() + i + FIELDS_PER_RECORD);
+        }
+        if (RBN == RESIZED_BLOCK) {
+            removedZip = records[records.size() - FIELDS_PER_RECORD];
+        }
+    }
+    int lowZip = stoi(table[10].records[0]);
+    int highZip = stoi(table[30].records[0]);
+    size_t rangeCount = set.rangeScan(lowZip, highZip, [](const vector<string>&) {});
+    CHECK(rangeCount > 0);
+
+    atomic<bool> writing{true};
+    mutex failureLatch;
+    int threadFailures = 0;
+    auto fail = [&]() {
+        lock_guard<mutex> guard(failureLatch);
+        threadFailures++;
+    };
+
+    thread renamer([&]() {
+        for (int i = 0; i < UPDATES; i++) {
+            int RBN = 1 + i % RENAMED_BLOCKS;
+            vector<string> records = table.at(RBN).records;
+            if ((i / RENAMED_BLOCKS) % 2 == 0) {
+                records[1] = RENAMED;
+            }
+            if (!set.updateBlock(RBN, records)) fail();
+        }
+    });
+    thread resizer([&]() {
+        const vector<string>& full = table.at(RESIZED_BLOCK).records;
+        vector<string> shorter(full.begin(), full.end() - FIELDS_PER_RECORD);
+        for (int i = 0; i < UPDATES; i++) {
+            if (!set.updateBlock(RESIZED_BLOCK, i % 2 == 0 ? shorter : full)) fail();
+        }
+        if (!set.updateBlock(RESIZED_BLOCK, full)) fail();
+    });
+
+    vector<thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&]() {
+            vector<string> fields;
+            while (writing) {
+                for (const auto& [zip, record] : expected) {
+                    bool found = set.search(zip, fields);
+                    if (zip == removedZip) {
+                        if (found && fields != record) fail();
+                        continue;
+                    }
+                    // Only the place name of a first record may differ
+                    if (!found || fields.size() != record.size() || fields[0] != zip || fields[2] != record[2]
+                        || (fields[1] != record[1] && fields[1] != RENAMED)) {
+                        fail();
+                    }
+                }
+            }
+        });
+    }
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&]() {
+            while (writing) {
+                int previous = -1;
+                size_t visited = set.rangeScan(lowZip, highZip, [&](const vector<string>& fields) {
+                    int zip = stoi(fields[0]);
+                    auto it = expected.find(fields[0]);
+                    if (zip < lowZip || zip > highZip || zip <= previous || it == expected.end()
+                        || fields[2] != it->second[2]) {
+                        fail();
+                    }
+                    previous = zip;
+                });
+                if (visited != rangeCount) fail();
+            }
+        });
+    }
+
+    renamer.join();
+    resizer.join();
+    writing = false;
+    for (thread& reader : readers) {
+        reader.join();
+    }
+    CHECK(threadFailures == 0);
+
+    // The last writes are what every reader sees afterwards
+    vector<string> fields;
+    CHECK(set.search(removedZip, fields) && fields == expected[removedZip]);
+    CHECK(set.search(table[1].records[0], fields) && fields[1] == table[1].records[1]);
+
+    return testResult("sequence_set_concurrency_test");
+}
@@ -0,0 +1,141 @@
+/**
+ * @file SnapshotSetTest.cpp
+ * @brief Checks that pinned readers keep their snapshot and that retired versions are freed after them.
+ *
+ * The EpochManager is checked on its own first. Then a SnapshotSet range scan
+ * is held in the middle of its range while another thread publishes a new
+ * version of a block further along; the scan must finish on the old version,
+ * new readers must see the new one, and the old versions must be freed by the
+ * first update after the scan has left.
+ *
+ *     snapshot_set_test <csv file> <scratch block file>
+ *
+ * @date 10/18/2026
+ */
+
+#include "Block.h"
+#include "EpochManager.h"
+#include "SnapshotSet.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Block the range scan is paused in.
+ */
+static const int FIRST_BLOCK = 10;
+
+/**
+ * @brief Block updated while the scan is paused; the scan reaches it afterwards.
+ */
+static const int UPDATED_BLOCK = 25;
+
+/**
+ * @brief Block the range scan ends in.
+ */
+static const int LAST_BLOCK = 30;
+
+/**
+ * @brief Checks that retired objects are freed only once no pinned reader predates them.
+ */
+static void checkEpochs() {
+    EpochManager epochs(4);
+    int freed = 0;
+    {
+        EpochManager::Guard early = epochs.pin();
+        epochs.retire([&]() { freed++; });
+        {
+            EpochManager::Guard late = epochs.pin();
+            CHECK(epochs.reclaim() == 0);
+        }
+        CHECK(epochs.reclaim() == 0);  // The early reader may still see it
+        CHECK(epochs.pendingReclaims() == 1);
+        CHECK(freed == 0);
+    }
+    CHECK(epochs.reclaim() == 1);
+    CHECK(freed == 1);
+    CHECK(epochs.pendingReclaims() == 0);
+
+    // A reader pinned after the retirement does not hold the object back
+    epochs.retire([&]() { freed++; });
+    EpochManager::Guard after = epochs.pin();
+    CHECK(epochs.reclaim() == 1);
+    CHECK(freed == 2);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <csv file> <scratch block file>" << endl;
+        return 1;
+    }
+    string csvFile = argv[1];
+    string blockFile = argv[2];
+
+    checkEpochs();
+
+    CHECK(createBlockFile(csvFile, blockFile));
+    map<int, Block> table;
+    CHECK(loadBlockFile(blockFile, table) != -1);
+    map<string, string> places;  ///< Place name of every record in the scanned blocks
+    for (int RBN = FIRST_BLOCK; RBN <= LAST_BLOCK; RBN++) {
+        materializeBlock(table[RBN]);
+        const vector<string>& records = table[RBN].records;
+        for (size_t i = 0; i + FIELDS_PER_RECORD <= records.size(); i += FIELDS_PER_RECORD) {
+            places[records[i]] = records[i + 1];
+        }
+    }
+    vector<string> renamed = table[UPDATED_BLOCK].records;
+    for (size_t i = 1; i < renamed.size(); i += FIELDS_PER_RECORD) {
+        renamed[i] = "Renamed Place";
+    }
+
+    SnapshotSet set;
+    CHECK(set.open(blockFile, false));
+    CHECK(set.retiredVersions() == 0);
+
+    atomic<bool> scanPaused{false};
+    atomic<bool> published{false};
+    thread writer([&]() {
+        while (!scanPaused) {
+            this_thread::yield();
+        }
+        CHECK(set.updateBlock(UPDATED_BLOCK, renamed));
+        published = true;
+    });
+
+    size_t oldPlaces = 0;
+    size_t retiredDuringScan = 0;
+    size_t visited = set.rangeScan(stoi(table[FIRST_BLOCK].records[0]), stoi(table[LAST_BLOCK].records[0]),
+                                   [&](const vector<string>& fields) {
+        if (!scanPaused) {
+            scanPaused = true;
+            while (!published) {
+                this_thread::yield();
+            }
+            retiredDuringScan = set.retiredVersions();
+        }
+        auto it = places.find(fields[0]);
+        oldPlaces += it != places.end() && it->second == fields[1];
+    });
+    writer.join();
+
+    // The scan started before the update, so it saw none of it
+    CHECK(visited > 0);
+    CHECK(oldPlaces == visited);
+    CHECK(retiredDuringScan > 0);
+
+    // New readers see the update; the old versions wait for the next writer
+    vector<string> fields;
+    CHECK(set.search(renamed[0], fields) && fields[1] == "Renamed Place");
+    CHECK(set.retiredVersions() == retiredDuringScan);
+    CHECK(set.updateBlock(UPDATED_BLOCK, table[UPDATED_BLOCK].records));
+    CHECK(set.retiredVersions() == 0);
+    CHECK(set.search(renamed[0], fields) && fields[1] == table[UPDATED_BLOCK].records[1]);
+
+    return testResult("snapshot_set_test");
+}
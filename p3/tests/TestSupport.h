@@ -0,0 +1,56 @@
+/**
+ * @file TestSupport.h
+ * @brief Check macro and file helpers shared by the p3 tests.
+ *
+ * Each test is a program run by CTest with the CSV file to build from and a
+ * scratch path in the build tree. A failed check prints its location and the
+ * program exits with status 1.
+ *
+ * @date 10/18/2026
+ */
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+/**
+ * @brief Number of checks that failed so far.
+ */
+inline int testFailures = 0;
+
+/**
+ * @brief Records a failure and prints the failed condition if it does not hold.
+ */
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            testFailures++;                                                               \
+        }                                                                                 \
+    } while (false)
+
+/**
+ * @brief Gets the size of a file.
+ * @param path Path of the file.
+ * @return Size in bytes, or -1 if the file does not exist.
+ */
+inline long long fileSize(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<long long>(info.st_size) : -1;
+}
+
+/**
+ * @brief Prints the outcome of a test and gets its exit status.
+ * @param name Name of the test.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+inline int testResult(const std::string& name) {
+    std::cout << name << ": " << (testFailures == 0 ? "passed" : "FAILED") << std::endl;
+    return testFailures == 0 ? 0 : 1;
+}
+
+#endif // TEST_SUPPORT_H
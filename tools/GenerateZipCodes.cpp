@@ -0,0 +1,366 @@
+/**
+ * @file GenerateZipCodes.cpp
+ * @brief Writes synthetic zip code CSV files of any size in the us_postal_codes.csv schema.
+ *
+ * Rows are derived from the places of a source CSV (the bundled
+ * us_postal_codes.csv by default), so names, states and coordinates stay
+ * realistic at any size:
+ *
+ * - Zip codes are unique. Rank i of n gets zip `first + i`, or a key inside a
+ *   dense run of `--cluster-size` keys for the clustered distribution.
+ * - Geography follows the zip code as it does in the source: rank i takes the
+ *   place at position i * places / n in source zip order, moved by up to
+ *   `--jitter` degrees and kept inside that state's bounding box from the source.
+ * - Counties and states keep their source cardinality. City names grow with
+ *   the square root of the scale, so a place repeated s times spreads over
+ *   about sqrt(s) names ("Holtsville", "Holtsville 2", ...).
+ *
+ * The distribution only decides the order rows are written in:
+ *
+ * - sorted:    ascending zip code
+ * - random:    a seeded pseudo-random permutation of the sorted rows
+ * - clustered: runs of consecutive zip codes separated by gaps, each run in
+ *              zip order and the runs in random order, like bulk loads by region
+ *
+ * Nothing is held per row, so memory stays at the size of the source file
+ * whatever the row count. The same seed always produces the same file.
+ * p3 keeps zip codes as int, so files meant for it must keep the largest
+ * key below 2^31; the generator warns when it does not.
+ *
+ * Build with the top level CMake build (`zipgen` target), or directly:
+ *     g++ -std=c++17 -O2 tools/GenerateZipCodes.cpp -o zipgen
+ *     ./zipgen --rows=10M --distribution=random --output=zips_10M.csv
+ *
+ * @date 10/18/2026
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Order the generated rows are written in.
+ */
+enum class Distribution {
+    Sorted,    ///< Ascending zip code
+    Random,    ///< Pseudo-random permutation of the zip codes
+    Clustered  ///< Runs of consecutive zip codes, runs in random order
+};
+
+/**
+ * @brief Command line options of the generator.
+ */
+struct GeneratorOptions {
+    uint64_t rows = 1000000;                          ///< Rows to write
+    Distribution distribution = Distribution::Sorted; ///< Order of the rows
+    uint64_t seed = 1;                                ///< Seed of every random choice
+    uint64_t firstZip = 501;                          ///< Smallest zip code
+    uint64_t clusterSize = 64;                        ///< Keys per run for the clustered distribution
+    uint64_t clusterGap = 4;                          ///< Key space per run, as a multiple of its size
+    double jitter = 0.05;                             ///< Largest move of a coordinate, in degrees
+    string sourceFile = "us_postal_codes.csv";        ///< Places the rows are derived from
+    string outputFile;                                ///< Output CSV; standard output when empty
+};
+
+/**
+ * @brief Bounding box of the source places of one state.
+ */
+struct StateBounds {
+    double minLatitude = 90, maxLatitude = -90;
+    double minLongitude = 180, maxLongitude = -180;
+};
+
+/**
+ * @brief One row of the source file.
+ */
+struct Place {
+    string city;
+    string state;
+    string county;
+    double latitude;
+    double longitude;
+    long zip;
+    StateBounds box;  ///< Bounds of the place's state, which its rows stay inside
+};
+
+/**
+ * @brief Mixes a 64-bit value (SplitMix64 finalizer).
+ *
+ * @param value Value to mix.
+ * @return Well distributed hash of the value.
+ */
+static uint64_t mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Maps a hash to a double in [-1, 1).
+ *
+ * @param hash Hash to map.
+ * @return Uniformly distributed value.
+ */
+static double unitSpread(uint64_t hash) {
+    return static_cast<double>(hash >> 11) / static_cast<double>(1ULL << 52) - 1.0;
+}
+
+/**
+ * @class Permutation
+ * @brief Seeded bijection of [0, size) evaluated without a table.
+ *
+ * A four round Feistel network over the smallest even number of bits that
+ * covers `size`, with cycle walking to stay below `size`.
+ */
+class Permutation {
+public:
+    Permutation(uint64_t size, uint64_t seed) : size(size), halfBits(1) {
+        while ((1ULL << (2 * halfBits)) < size) {
+            halfBits++;
+        }
+        for (int round = 0; round < 4; round++) {
+            keys[round] = mix(seed + round);
+        }
+    }
+
+    /**
+     * @brief Gets the image of a value.
+     *
+     * @param value Value below the size.
+     * @return Image below the size.
+     */
+    uint64_t operator()(uint64_t value) const {
+        do {
+            value = encrypt(value);
+        } while (value >= size);
+        return value;
+    }
+
+private:
+    uint64_t size;
+    int halfBits;
+    uint64_t keys[4];
+
+    uint64_t encrypt(uint64_t value) const {
+        uint64_t mask = (1ULL << halfBits) - 1;
+        uint64_t left = value >> halfBits, right = value & mask;
+        for (uint64_t key : keys) {
+            uint64_t next = left ^ (mix(right ^ key) & mask);
+            left = right;
+            right = next;
+        }
+        return (left << halfBits) | right;
+    }
+};
+
+/**
+ * @brief Reads a count such as 40000, 10k, 25M or 2G.
+ *
+ * @param text Count text.
+ * @param count Receives the count.
+ * @return True if the text is a positive count, false otherwise.
+ */
+static bool parseCount(const string& text, uint64_t& count) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    string suffix = end;
+    if (suffix == "k" || suffix == "K") value *= 1e3;
+    else if (suffix == "m" || suffix == "M") value *= 1e6;
+    else if (suffix == "g" || suffix == "G") value *= 1e9;
+    else if (!suffix.empty()) return false;
+    if (text.empty() || value < 1) {
+        return false;
+    }
+    count = static_cast<uint64_t>(value);
+    return true;
+}
+
+/**
+ * @brief Reads the generator options from the command line.
+ *
+ * @param argc Argument count from main.
+ * @param argv Arguments from main.
+ * @param options Receives the options; unspecified ones keep their defaults.
+ * @return True if every argument was understood, false otherwise.
+ */
+static bool parseOptions(int argc, char* argv[], GeneratorOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        size_t equals = argument.find('=');
+        string name = argument.substr(0, equals);
+        string value = equals == string::npos ? "" : argument.substr(equals + 1);
+        bool ok = true;
+        if (name == "--rows") {
+            ok = parseCount(value, options.rows);
+        } else if (name == "--distribution") {
+            if (value == "sorted") options.distribution = Distribution::Sorted;
+            else if (value == "random") options.distribution = Distribution::Random;
+            else if (value == "clustered") options.distribution = Distribution::Clustered;
+            else ok = false;
+        } else if (name == "--seed") {
+            options.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "--first-zip") {
+            options.firstZip = strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "--cluster-size") {
+            ok = parseCount(value, options.clusterSize);
+        } else if (name == "--cluster-gap") {
+            ok = parseCount(value, options.clusterGap);
+        } else if (name == "--jitter") {
+            options.jitter = atof(value.c_str());
+        } else if (name == "--source") {
+            options.sourceFile = value;
+        } else if (name == "--output") {
+            options.outputFile = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            cerr << "Invalid option " << argument << "\n"
+                 << "Usage: " << argv[0] << " [--rows=1M] [--distribution=sorted|random|clustered] [--seed=1]\n"
+                 << "       [--first-zip=501] [--cluster-size=64] [--cluster-gap=4] [--jitter=0.05]\n"
+                 << "       [--source=us_postal_codes.csv] [--output=file.csv]" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the places of the source file in zip code order.
+ *
+ * @param sourceFile Source CSV in the us_postal_codes.csv schema.
+ * @param places Receives the places.
+ * @return True if at least one place was read, false otherwise.
+ */
+static bool loadPlaces(const string& sourceFile, vector<Place>& places) {
+    map<string, StateBounds> bounds;
+    ifstream in(sourceFile);
+    if (!in.is_open()) {
+        cerr << "Error: Could not open " << sourceFile << endl;
+        return false;
+    }
+    string line;
+    getline(in, line);  // Skip header
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        vector<string> fields;
+        size_t start = 0, comma;
+        while ((comma = line.find(',', start)) != string::npos) {
+            fields.push_back(line.substr(start, comma - start));
+            start = comma + 1;
+        }
+        fields.push_back(line.substr(start));
+        if (fields.size() != 6) {
+            continue;
+        }
+        Place place{fields[1], fields[2], fields[3], atof(fields[4].c_str()), atof(fields[5].c_str()),
+                    atol(fields[0].c_str()), {}};
+        StateBounds& box = bounds[place.state];
+        box.minLatitude = min(box.minLatitude, place.latitude);
+        box.maxLatitude = max(box.maxLatitude, place.latitude);
+        box.minLongitude = min(box.minLongitude, place.longitude);
+        box.maxLongitude = max(box.maxLongitude, place.longitude);
+        places.push_back(move(place));
+    }
+    stable_sort(places.begin(), places.end(), [](const Place& a, const Place& b) { return a.zip < b.zip; });
+    for (Place& place : places) {
+        place.box = bounds[place.state];
+    }
+    if (places.empty()) {
+        cerr << "Error: No records in " << sourceFile << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    vector<Place> places;
+    if (!loadPlaces(options.sourceFile, places)) {
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (!options.outputFile.empty()) {
+        out = fopen(options.outputFile.c_str(), "w");
+        if (!out) {
+            cerr << "Error: Could not open " << options.outputFile << endl;
+            return 1;
+        }
+    }
+    static char outputBuffer[1 << 20];
+    setvbuf(out, outputBuffer, _IOFBF, sizeof(outputBuffer));
+
+    const uint64_t rows = options.rows;
+    const bool clustered = options.distribution == Distribution::Clustered;
+    const uint64_t clusterSize = clustered ? options.clusterSize : 1;
+    const uint64_t clusterStride = clustered ? options.clusterSize * options.clusterGap : 1;
+    const uint64_t clusters = (rows + clusterSize - 1) / clusterSize;
+    const uint64_t lastZip = options.firstZip + (clusters - 1) * clusterStride + (clusterSize - 1);
+    if (lastZip > static_cast<uint64_t>(INT_MAX)) {
+        cerr << "Warning: zip codes reach " << lastZip << ", beyond the int keys used by p3" << endl;
+    }
+
+    // Names per place grow with the square root of the rows sharing it
+    const double perPlace = static_cast<double>(rows) / places.size();
+    const uint64_t variants = perPlace > 1 ? static_cast<uint64_t>(ceil(sqrt(perPlace))) : 1;
+    Permutation order(options.distribution == Distribution::Sorted ? 1 : clusters, options.seed);
+
+    fputs("\"Zip Code\",\"Place Name\",State,County,Lat,Long\n", out);
+    char line[512];
+    for (uint64_t next = 0; next < clusters; next++) {
+        uint64_t cluster = options.distribution == Distribution::Sorted ? next : order(next);
+        uint64_t count = min(clusterSize, rows - cluster * clusterSize);  // The last run may be short
+        for (uint64_t offset = 0; offset < count; offset++) {
+            // Rank of the row in zip order, and its zip code
+            uint64_t rank = cluster * clusterSize + offset;
+            uint64_t zip = options.firstZip + cluster * clusterStride + offset;
+
+            const Place& place = places[static_cast<size_t>(rank * places.size() / rows)];
+            uint64_t hash = mix(options.seed ^ mix(zip));
+            uint64_t variant = mix(hash) % variants;
+            double latitude = clamp(place.latitude + options.jitter * unitSpread(mix(hash + 1)),
+                                    place.box.minLatitude, place.box.maxLatitude);
+            double longitude = clamp(place.longitude + options.jitter * unitSpread(mix(hash + 2)),
+                                     place.box.minLongitude, place.box.maxLongitude);
+
+            int length;
+            if (variant == 0) {
+                length = snprintf(line, sizeof(line), "%llu,%s,%s,%s,%.4f,%.4f\n",
+                                  static_cast<unsigned long long>(zip), place.city.c_str(), place.state.c_str(),
+                                  place.county.c_str(), latitude, longitude);
+            } else {
+                length = snprintf(line, sizeof(line), "%llu,%s %llu,%s,%s,%.4f,%.4f\n",
+                                  static_cast<unsigned long long>(zip), place.city.c_str(),
+                                  static_cast<unsigned long long>(variant + 1), place.state.c_str(),
+                                  place.county.c_str(), latitude, longitude);
+            }
+            fwrite(line, 1, static_cast<size_t>(min(length, static_cast<int>(sizeof(line)) - 1)), out);
+        }
+    }
+
+    if (fflush(out) != 0 || ferror(out)) {
+        cerr << "Error: Could not write " << (options.outputFile.empty() ? "standard output" : options.outputFile) << endl;
+        return 1;
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}